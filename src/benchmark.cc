@@ -0,0 +1,2310 @@
+// Copyright Nezametdinov E. Ildus 2025.
+// Distributed under the Boost Software License, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at
+// https://www.boost.org/LICENSE_1_0.txt)
+//
+#include <everything>
+#include <vulkan/vulkan.h>
+
+import rose.vulkan.allocator;
+import rose.vulkan.compilation;
+import rose.vulkan.compute;
+import rose.vulkan.culling;
+import rose.vulkan.device;
+import rose.vulkan.memory;
+import rose.vulkan.offscreen;
+import rose.vulkan.recording;
+import rose.vulkan.scheduler;
+import rose.vulkan.staging;
+import rose.vulkan.streaming;
+
+namespace rose {
+
+////////////////////////////////////////////////////////////////////////////////
+// Error definition.
+////////////////////////////////////////////////////////////////////////////////
+
+struct error {
+    long long line;
+    vulkan::error underlying;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark parameters definition.
+////////////////////////////////////////////////////////////////////////////////
+
+struct benchmark_parameters {
+    // Number of measured runs of each benchmark (each benchmark also has one
+    // warm-up run, which is not measured).
+    uint32_t run_count;
+
+    // Number of operations in a run of latency and rate benchmarks.
+    uint32_t iteration_count;
+
+    // Number of bytes which are transferred in a run of bandwidth benchmarks.
+    VkDeviceSize transfer_size;
+
+    // Path to the SPIR-V code of the compute benchmark shader
+    // (shaders/saxpy.comp).
+    std::filesystem::path compute_shader_path;
+
+    // Path to the SPIR-V code of the culling shader (shaders/culling.comp).
+    std::filesystem::path culling_shader_path;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Measurement definition.
+////////////////////////////////////////////////////////////////////////////////
+
+// Note: Each measured run of a benchmark produces one sample. Run-to-run
+// variance is reported as the standard deviation of samples.
+struct measurement {
+    // Name of the benchmark, its variant, and the size of its operations.
+    std::string benchmark, variant;
+    VkDeviceSize size;
+
+    // Unit of samples.
+    std::string unit;
+
+    // Samples.
+    std::vector<double> samples;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Measurement summary definition.
+////////////////////////////////////////////////////////////////////////////////
+
+struct measurement_summary {
+    double mean, standard_deviation, min, max;
+};
+
+auto
+summarize(std::span<double const> samples) noexcept -> measurement_summary {
+    if(samples.empty()) {
+        return {};
+    }
+
+    auto n = static_cast<double>(samples.size());
+    auto result = measurement_summary{
+        .min = std::ranges::min(samples), .max = std::ranges::max(samples)};
+
+    for(auto x : samples) {
+        result.mean += x / n;
+    }
+
+    for(auto x : samples) {
+        result.standard_deviation += (x - result.mean) * (x - result.mean);
+    }
+
+    result.standard_deviation =
+        sqrt(result.standard_deviation / std::max(n - 1.0, 1.0));
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark context definition.
+////////////////////////////////////////////////////////////////////////////////
+
+struct benchmark_context {
+    // Parameters.
+    benchmark_parameters parameters;
+
+    // Instance and selected physical device.
+    vulkan::instance instance;
+    vulkan::physical_device physical_device;
+
+    // Device and its submission scheduler.
+    vulkan::device device;
+    vulkan::scheduler scheduler;
+
+    // Flag which indicates that VK_EXT_memory_budget is enabled on the device.
+    bool is_budget_extension_enabled;
+
+    // Job pool, and command buffer recorder which uses it.
+    vulkan::job_pool job_pool;
+    vulkan::recorder recorder;
+
+    // Device-local buffer which is the target of recorded commands, and its
+    // memory.
+    vulkan::buffer buffer;
+    vulkan::memory buffer_memory;
+
+    // Results.
+    std::vector<measurement> measurements;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Benchmark context initialization function.
+////////////////////////////////////////////////////////////////////////////////
+
+// Note: The context is headless, and accepts devices of any type, so that the
+// benchmarks can run on CPU implementations, such as lavapipe.
+auto
+initialize_benchmark_context(benchmark_parameters parameters)
+    -> std::expected<benchmark_context, error> {
+    // Initialize an empty result.
+    auto context = benchmark_context{.parameters = parameters};
+
+    // Initialize Vulkan instance.
+    if(true) {
+        auto object = initialize(
+            vulkan::instance_parameters{.api_version = VK_API_VERSION_1_3});
+
+        if(!object) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = object.error()}};
+        } else {
+            context.instance = std::move(*object);
+        }
+    }
+
+    // Select physical device.
+    if(true) {
+        auto object = select(
+            context.instance, vulkan::physical_device_preference{
+                                  .api_version = VK_API_VERSION_1_3});
+
+        if(!object) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = object.error()}};
+        } else {
+            context.physical_device = *object;
+        }
+    }
+
+    // Obtain physical device features.
+    auto features = vulkan::physical_device_features{context.physical_device};
+    if(!features.vulkan_1_2.timelineSemaphore ||
+       !features.vulkan_1_3.synchronization2) {
+        return std::unexpected{error{.line = __LINE__}};
+    }
+
+    // Enable VK_EXT_memory_budget, if supported.
+    auto extensions = std::vector<char const*>{};
+    if(auto n = uint32_t{}; true) {
+        auto properties_list = std::vector<VkExtensionProperties>{};
+        vkEnumerateDeviceExtensionProperties(
+            context.physical_device, nullptr, &n, nullptr);
+        properties_list.resize(n);
+        vkEnumerateDeviceExtensionProperties(
+            context.physical_device, nullptr, &n, properties_list.data());
+        properties_list.resize(n);
+
+        context.is_budget_extension_enabled =
+            std::ranges::any_of(properties_list, [](auto const& x) {
+                return std::string_view{x.extensionName} ==
+                       VK_EXT_MEMORY_BUDGET_EXTENSION_NAME;
+            });
+
+        if(context.is_budget_extension_enabled) {
+            extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        }
+    }
+
+    // Initialize Vulkan device.
+    if(true) {
+        auto object = initialize(
+            context.physical_device,
+            vulkan::device_parameters{
+                .extensions = extensions, .features = features});
+
+        if(!object) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = object.error()}};
+        } else {
+            context.device = std::move(*object);
+        }
+    }
+
+    // Initialize submission scheduler.
+    if(true) {
+        auto object =
+            initialize(context.device, obtain_queue_list(context.device));
+
+        if(!object) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = object.error()}};
+        } else {
+            context.scheduler = std::move(*object);
+        }
+    }
+
+    // Initialize job pool.
+    if(true) {
+        auto object = initialize(vulkan::job_pool_parameters{});
+        if(!object) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = object.error()}};
+        } else {
+            context.job_pool = std::move(*object);
+        }
+    }
+
+    // Initialize command buffer recorder. Benchmarks which submit commands
+    // use two frames in flight.
+    if(true) {
+        auto object = initialize(
+            context.device, context.job_pool,
+            vulkan::recording_parameters{
+                .queue_family_index =
+                    context.device.queue_family_index.graphics,
+                .frame_count = 2});
+
+        if(!object) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = object.error()}};
+        } else {
+            context.recorder = std::move(*object);
+        }
+    }
+
+    // Create the target buffer.
+    if(true) {
+        auto object = initialize<vulkan::buffer>(
+            vkCreateBuffer, context.device,
+            {.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+             .size = 65536,
+             .usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+             .sharingMode = VK_SHARING_MODE_EXCLUSIVE});
+
+        if(!object) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = object.error()}};
+        } else {
+            context.buffer = std::move(*object);
+        }
+    }
+
+    // Allocate and bind its memory.
+    if(auto requirements = VkMemoryRequirements{}; true) {
+        vkGetBufferMemoryRequirements(
+            context.device, context.buffer, &requirements);
+
+        auto object = allocate(
+            context.device,
+            vulkan::memory_allocation_parameters{
+                .requirements = requirements,
+                .property_flags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                .resource_kind = vulkan::memory_resource_kind::linear});
+
+        if(!object) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = object.error()}};
+        } else {
+            context.buffer_memory = std::move(*object);
+        }
+
+        if(auto code = vkBindBufferMemory(
+               context.device, context.buffer, context.buffer_memory, 0);
+           code != VK_SUCCESS) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = {__LINE__, code}}};
+        }
+    }
+
+    return std::move(context);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Measurement function.
+////////////////////////////////////////////////////////////////////////////////
+
+using clock = std::chrono::steady_clock;
+
+// Note: Converts the duration of a run to a sample. Rates are measured in
+// operations per second, and latencies are measured in nanoseconds per
+// operation.
+auto
+compute_rate(clock::duration duration, double operation_count) -> double {
+    return operation_count /
+           std::max(std::chrono::duration<double>{duration}.count(), 1e-9);
+}
+
+auto
+compute_latency(clock::duration duration, double operation_count) -> double {
+    return std::chrono::duration<double, std::nano>{duration}.count() /
+           std::max(operation_count, 1.0);
+}
+
+// Note: Executes one warm-up run and the given number of measured runs of the
+// benchmark. Each run returns a sample.
+template <typename F>
+auto
+measure(benchmark_context& context, measurement x, F const& f)
+    -> std::expected<void, error> {
+    for(auto i = 0U; i <= context.parameters.run_count; ++i) {
+        auto sample = f();
+        if(!sample) {
+            return std::unexpected{sample.error()};
+        }
+
+        if(i != 0) {
+            x.samples.push_back(*sample);
+        }
+    }
+
+    context.measurements.push_back(std::move(x));
+    return {};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Memory allocation benchmarks.
+////////////////////////////////////////////////////////////////////////////////
+
+// Note: Latency is measured by allocating and freeing one object at a time;
+// throughput is measured by allocating a batch of live objects, which are
+// freed afterwards. The memory manager is measured with buffers, including
+// their creation and destruction.
+auto
+run_allocation_benchmarks(benchmark_context& context)
+    -> std::expected<void, error> {
+    auto n = context.parameters.iteration_count;
+    auto parameters = vulkan::memory_allocation_parameters{
+        .requirements =
+            {.size = 65536, .alignment = 256, .memoryTypeBits = ~0U},
+        .property_flags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        .resource_kind = vulkan::memory_resource_kind::linear};
+
+    // Initialize a memory pool.
+    auto pool = initialize(
+        context.device, vulkan::memory_pool_parameters{.block_size = 1 << 26});
+
+    if(!pool) {
+        return std::unexpected{
+            error{.line = __LINE__, .underlying = pool.error()}};
+    }
+
+    auto memories = std::vector<vulkan::memory>{};
+    auto allocations = std::vector<vulkan::memory_allocation>{};
+
+    memories.reserve(n);
+    allocations.reserve(n);
+
+    // Device memory allocation latency.
+    auto result = measure(
+        context,
+        {.benchmark = "allocate/latency",
+         .variant = "device",
+         .size = parameters.requirements.size,
+         .unit = "ns/op"},
+        [&]() -> std::expected<double, error> {
+            auto duration = clock::duration{};
+            for(auto i = 0U; i != n; ++i) {
+                auto t0 = clock::now();
+                auto memory = allocate(context.device, parameters);
+                duration += clock::now() - t0;
+
+                if(!memory) {
+                    return std::unexpected{
+                        error{.line = __LINE__, .underlying = memory.error()}};
+                }
+            }
+
+            return compute_latency(duration, n);
+        });
+
+    if(!result) {
+        return result;
+    }
+
+    // Device memory allocation throughput.
+    result = measure(
+        context,
+        {.benchmark = "allocate/throughput",
+         .variant = "device",
+         .size = parameters.requirements.size,
+         .unit = "op/s"},
+        [&]() -> std::expected<double, error> {
+            auto t0 = clock::now();
+            for(auto i = 0U; i != n; ++i) {
+                auto memory = allocate(context.device, parameters);
+                if(!memory) {
+                    return std::unexpected{
+                        error{.line = __LINE__, .underlying = memory.error()}};
+                }
+
+                memories.push_back(std::move(*memory));
+            }
+
+            auto t1 = clock::now();
+            memories.clear();
+
+            return compute_rate(t1 - t0, n);
+        });
+
+    if(!result) {
+        return result;
+    }
+
+    // Pool allocation latency.
+    result = measure(
+        context,
+        {.benchmark = "allocate/latency",
+         .variant = "pool",
+         .size = parameters.requirements.size,
+         .unit = "ns/op"},
+        [&]() -> std::expected<double, error> {
+            auto duration = clock::duration{};
+            for(auto i = 0U; i != n; ++i) {
+                auto t0 = clock::now();
+                auto allocation = allocate(*pool, parameters);
+                duration += clock::now() - t0;
+
+                if(!allocation) {
+                    return std::unexpected{error{
+                        .line = __LINE__, .underlying = allocation.error()}};
+                }
+
+                deallocate(*pool, *allocation);
+            }
+
+            return compute_latency(duration, n);
+        });
+
+    if(!result) {
+        return result;
+    }
+
+    // Pool allocation throughput.
+    result = measure(
+        context,
+        {.benchmark = "allocate/throughput",
+         .variant = "pool",
+         .size = parameters.requirements.size,
+         .unit = "op/s"},
+        [&]() -> std::expected<double, error> {
+            auto t0 = clock::now();
+            for(auto i = 0U; i != n; ++i) {
+                auto allocation = allocate(*pool, parameters);
+                if(!allocation) {
+                    return std::unexpected{error{
+                        .line = __LINE__, .underlying = allocation.error()}};
+                }
+
+                allocations.push_back(*allocation);
+            }
+
+            auto t1 = clock::now();
+            for(auto allocation : allocations) {
+                deallocate(*pool, allocation);
+            }
+
+            allocations.clear();
+            return compute_rate(t1 - t0, n);
+        });
+
+    if(!result) {
+        return result;
+    }
+
+    // Initialize a memory manager.
+    auto manager = initialize(
+        context.device,
+        vulkan::memory_manager_parameters{
+            .pool = {.block_size = 1 << 26},
+            .is_budget_extension_enabled =
+                context.is_budget_extension_enabled});
+
+    if(!manager) {
+        return std::unexpected{
+            error{.line = __LINE__, .underlying = manager.error()}};
+    }
+
+    auto resources = std::vector<uint32_t>{};
+    resources.reserve(n);
+
+    auto buffer_parameters = [&] {
+        return vulkan::managed_buffer_parameters{
+            .info = {.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+                     .size = parameters.requirements.size,
+                     .usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT},
+            .property_flags = parameters.property_flags};
+    };
+
+    // Memory manager latency. Resources are not used by the GPU, so they are
+    // released at empty points.
+    result = measure(
+        context,
+        {.benchmark = "allocate/latency",
+         .variant = "manager",
+         .size = parameters.requirements.size,
+         .unit = "ns/op"},
+        [&]() -> std::expected<double, error> {
+            update_budget(*manager);
+
+            auto duration = clock::duration{};
+            for(auto i = 0U; i != n; ++i) {
+                auto t0 = clock::now();
+                auto resource = create(*manager, buffer_parameters());
+                if(!resource) {
+                    return std::unexpected{error{
+                        .line = __LINE__, .underlying = resource.error()}};
+                }
+
+                destroy(*manager, resource->id, {});
+                if(auto r = collect(*manager); !r) {
+                    return std::unexpected{
+                        error{.line = __LINE__, .underlying = r.error()}};
+                }
+
+                duration += clock::now() - t0;
+            }
+
+            return compute_latency(duration, n);
+        });
+
+    if(!result) {
+        return result;
+    }
+
+    // Memory manager throughput.
+    result = measure(
+        context,
+        {.benchmark = "allocate/throughput",
+         .variant = "manager",
+         .size = parameters.requirements.size,
+         .unit = "op/s"},
+        [&]() -> std::expected<double, error> {
+            update_budget(*manager);
+
+            auto t0 = clock::now();
+            for(auto i = 0U; i != n; ++i) {
+                auto resource = create(*manager, buffer_parameters());
+                if(!resource) {
+                    return std::unexpected{error{
+                        .line = __LINE__, .underlying = resource.error()}};
+                }
+
+                resources.push_back(resource->id);
+            }
+
+            auto t1 = clock::now();
+            for(auto id : resources) {
+                destroy(*manager, id, {});
+            }
+
+            resources.clear();
+            if(auto r = collect(*manager); !r) {
+                return std::unexpected{
+                    error{.line = __LINE__, .underlying = r.error()}};
+            }
+
+            return compute_rate(t1 - t0, n);
+        });
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Memory transfer benchmarks.
+////////////////////////////////////////////////////////////////////////////////
+
+auto
+obtain_memory_type_name(uint32_t index, VkMemoryPropertyFlags flags)
+    -> std::string {
+    auto result = "type" + std::to_string(index);
+
+    std::pair<VkMemoryPropertyFlags, char const*> names[] = {
+        {VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, "-device_local"},
+        {VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, "-host_coherent"},
+        {VK_MEMORY_PROPERTY_HOST_CACHED_BIT, "-host_cached"}};
+
+    for(auto [flag, name] : names) {
+        if((flags & flag) != 0) {
+            result += name;
+        }
+    }
+
+    return result;
+}
+
+// Note: Measures bandwidth of read and write functions for each host-visible
+// memory type, both with persistently mapped memory, and with memory which is
+// mapped by each call.
+auto
+run_transfer_benchmarks(benchmark_context& context)
+    -> std::expected<void, error> {
+    auto const& memory_properties =
+        context.physical_device.memory_properties;
+
+    // Initialize host data.
+    VkDeviceSize sizes[] = {1 << 12, 1 << 16, 1 << 20, 1 << 24};
+    auto data = std::vector<std::byte>(sizes[std::size(sizes) - 1]);
+
+    for(auto i = 0zU; i != data.size(); ++i) {
+        data[i] = static_cast<std::byte>(i * 31);
+    }
+
+    for(auto i = uint32_t{}; i != memory_properties.memoryTypeCount; ++i) {
+        // Skip memory types which are not host-visible.
+        auto flags = memory_properties.memoryTypes[i].propertyFlags;
+        if((flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) == 0) {
+            continue;
+        }
+
+        auto name = obtain_memory_type_name(i, flags);
+
+        for(auto size : sizes) {
+            // Allocate memory of this type. Sizes which do not fit into the
+            // heap are skipped.
+            auto memory = allocate(
+                context.device,
+                vulkan::memory_allocation_parameters{
+                    .requirements = {.size = size, .memoryTypeBits = 1U << i},
+                    .property_flags = flags,
+                    .resource_kind = vulkan::memory_resource_kind::linear});
+
+            if(!memory) {
+                continue;
+            }
+
+            // Map the memory persistently.
+            void* mapped = nullptr;
+            if(auto code = vkMapMemory(
+                   context.device, *memory, 0, VK_WHOLE_SIZE, 0, &mapped);
+               code != VK_SUCCESS) {
+                return std::unexpected{
+                    error{.line = __LINE__, .underlying = {__LINE__, code}}};
+            }
+
+            auto chunks = std::array{
+                std::pair{
+                    "mapped",
+                    vulkan::memory_chunk{
+                        context.device, *memory, 0,
+                        vulkan::memory_mapping{
+                            .data = static_cast<std::byte*>(mapped),
+                            .size = size,
+                            .property_flags = flags,
+                            .atom_size = context.physical_device.properties
+                                             .limits.nonCoherentAtomSize}}},
+                std::pair{"unmapped", vulkan::memory_chunk{}}};
+
+            // Measure the bandwidth.
+            auto n = std::max(
+                context.parameters.transfer_size / size, VkDeviceSize{1});
+            auto buffer = std::span{data}.first(size);
+
+            for(auto& [kind, chunk] : chunks) {
+                // Unmap the memory before measuring unmapped transfers.
+                if(chunk.memory == nullptr) {
+                    vkUnmapMemory(context.device, *memory);
+                    chunk = vulkan::memory_chunk{*memory};
+                }
+
+                auto variant = name + "/" + kind;
+                auto transfer = [&](auto const& f) {
+                    return [&]() -> std::expected<double, error> {
+                        auto t0 = clock::now();
+                        for(auto j = 0zU; j != n; ++j) {
+                            if(auto r = f(); !r) {
+                                return std::unexpected{error{
+                                    .line = __LINE__, .underlying = r.error()}};
+                            }
+                        }
+
+                        return compute_rate(clock::now() - t0, n * size) /
+                               (1 << 20);
+                    };
+                };
+
+                if(auto r = measure(
+                       context,
+                       {.benchmark = "write",
+                        .variant = variant,
+                        .size = size,
+                        .unit = "MiB/s"},
+                       transfer([&] { return write(chunk, buffer); }));
+                   !r) {
+                    return r;
+                }
+
+                if(auto r = measure(
+                       context,
+                       {.benchmark = "read",
+                        .variant = variant,
+                        .size = size,
+                        .unit = "MiB/s"},
+                       transfer([&] { return read(chunk, buffer); }));
+                   !r) {
+                    return r;
+                }
+
+                // Measure transfers which are split between workers.
+                if(chunk.mapping.data == nullptr) {
+                    continue;
+                }
+
+                auto& pool = context.job_pool;
+                if(auto r = measure(
+                       context,
+                       {.benchmark = "write",
+                        .variant = variant + "_parallel",
+                        .size = size,
+                        .unit = "MiB/s"},
+                       transfer([&] { return write(chunk, buffer, pool); }));
+                   !r) {
+                    return r;
+                }
+
+                if(auto r = measure(
+                       context,
+                       {.benchmark = "read",
+                        .variant = variant + "_parallel",
+                        .size = size,
+                        .unit = "MiB/s"},
+                       transfer([&] { return read(chunk, buffer, pool); }));
+                   !r) {
+                    return r;
+                }
+            }
+        }
+    }
+
+    return {};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Staging benchmarks.
+////////////////////////////////////////////////////////////////////////////////
+
+// Note: Measures bandwidth of uploads to the target buffer through the staging
+// ring, including the copies on the transfer queue. A batch is submitted each
+// time a quarter of the ring is filled, and each run waits for its last batch.
+auto
+run_staging_benchmarks(benchmark_context& context)
+    -> std::expected<void, error> {
+    constexpr auto capacity = VkDeviceSize{1 << 24};
+
+    // Initialize staging. Uploaded data is not used by other queues.
+    auto staging = initialize(
+        context.device,
+        vulkan::staging_parameters{
+            .capacity = capacity,
+            .batch_count = 4,
+            .destination_queue_family_index =
+                context.device.queue_family_index.transfer});
+
+    if(!staging) {
+        return std::unexpected{
+            error{.line = __LINE__, .underlying = staging.error()}};
+    }
+
+    // Make sure the GPU completes submitted work before staging is destroyed.
+    struct guard {
+        ~guard() {
+            vkDeviceWaitIdle(device);
+        }
+
+        VkDevice device;
+    } _{.device = context.device};
+
+    // Initialize host data. Uploads cycle through the target buffer.
+    VkDeviceSize sizes[] = {1 << 12, 1 << 16};
+    auto data = std::vector<std::byte>(sizes[std::size(sizes) - 1]);
+
+    for(auto size : sizes) {
+        auto n =
+            std::max(context.parameters.transfer_size / size, VkDeviceSize{1});
+        auto batch_size = std::max(capacity / 4 / size, VkDeviceSize{1});
+
+        auto result = measure(
+            context,
+            {.benchmark = "staging/upload",
+             .variant = "buffer",
+             .size = size,
+             .unit = "MiB/s"},
+            [&]() -> std::expected<double, error> {
+                auto t0 = clock::now();
+                auto submission = vulkan::staging_submission{};
+
+                for(auto i = VkDeviceSize{}; i != n; ++i) {
+                    if(auto r = upload(
+                           *staging, std::span{data}.first(size),
+                           vulkan::staging_buffer_target{
+                               .buffer = context.buffer,
+                               .offset = (i * size) % sizes[1]});
+                       !r) {
+                        return std::unexpected{
+                            error{.line = __LINE__, .underlying = r.error()}};
+                    }
+
+                    if((((i + 1) % batch_size) != 0) && ((i + 1) != n)) {
+                        continue;
+                    }
+
+                    if(auto r = submit(*staging, false); !r) {
+                        return std::unexpected{
+                            error{.line = __LINE__, .underlying = r.error()}};
+                    } else {
+                        submission = *r;
+                    }
+                }
+
+                if(auto code = vkWaitForFences(
+                       context.device, 1, &(submission.fence), VK_TRUE,
+                       UINT64_MAX);
+                   code != VK_SUCCESS) {
+                    return std::unexpected{error{
+                        .line = __LINE__, .underlying = {__LINE__, code}}};
+                }
+
+                return compute_rate(clock::now() - t0, n * size) / (1 << 20);
+            });
+
+        if(!result) {
+            return result;
+        }
+    }
+
+    return {};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Copy kernel benchmarks.
+////////////////////////////////////////////////////////////////////////////////
+
+auto
+obtain_instruction_set_name(vulkan::instruction_set x) -> char const* {
+    switch(x) {
+        case vulkan::instruction_set::sse4_1:
+            return "sse4_1";
+
+        case vulkan::instruction_set::avx2:
+            return "avx2";
+
+        case vulkan::instruction_set::avx512:
+            return "avx512";
+
+        default:
+            return "scalar";
+    }
+}
+
+// Note: Compares regular copies with streaming copies between host memory
+// and persistently mapped memory of each host-visible memory type.
+auto
+run_copy_benchmarks(benchmark_context& context)
+    -> std::expected<void, error> {
+    auto const& memory_properties =
+        context.physical_device.memory_properties;
+
+    auto size = VkDeviceSize{1 << 24};
+    auto n = std::max(context.parameters.transfer_size / size, VkDeviceSize{1});
+    auto data = std::vector<std::byte>(size);
+
+    auto instruction_set_name =
+        obtain_instruction_set_name(vulkan::obtain_instruction_set());
+
+    for(auto i = uint32_t{}; i != memory_properties.memoryTypeCount; ++i) {
+        // Skip memory types which are not host-visible.
+        auto flags = memory_properties.memoryTypes[i].propertyFlags;
+        if((flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) == 0) {
+            continue;
+        }
+
+        // Allocate and map memory of this type.
+        auto memory = allocate(
+            context.device,
+            vulkan::memory_allocation_parameters{
+                .requirements = {.size = size, .memoryTypeBits = 1U << i},
+                .property_flags = flags,
+                .resource_kind = vulkan::memory_resource_kind::linear});
+
+        if(!memory) {
+            continue;
+        }
+
+        void* mapped = nullptr;
+        if(auto code = vkMapMemory(
+               context.device, *memory, 0, VK_WHOLE_SIZE, 0, &mapped);
+           code != VK_SUCCESS) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = {__LINE__, code}}};
+        }
+
+        // Measure the bandwidth of each kind of copy.
+        auto mapped_data = static_cast<std::byte*>(mapped);
+        auto name = obtain_memory_type_name(i, flags);
+
+        std::tuple<char const*, char const*, vulkan::copy_kind> kinds[] = {
+            {"write", "regular", vulkan::copy_kind::regular},
+            {"write", "streaming", vulkan::copy_kind::streaming_store},
+            {"read", "regular", vulkan::copy_kind::regular},
+            {"read", "streaming", vulkan::copy_kind::streaming_load}};
+
+        for(auto [benchmark, kind_name, kind] : kinds) {
+            auto is_read = (std::string_view{benchmark} == "read");
+            auto result = measure(
+                context,
+                {.benchmark = std::string{"copy/"} + benchmark,
+                 .variant = name + "/" + kind_name + "/" + instruction_set_name,
+                 .size = size,
+                 .unit = "MiB/s"},
+                [&]() -> std::expected<double, error> {
+                    auto t0 = clock::now();
+                    for(auto j = VkDeviceSize{}; j != n; ++j) {
+                        if(auto host_data = data.data(); is_read) {
+                            vulkan::copy_memory(
+                                host_data, mapped_data, size, kind);
+                        } else {
+                            vulkan::copy_memory(
+                                mapped_data, host_data, size, kind);
+                        }
+                    }
+
+                    return compute_rate(clock::now() - t0, n * size) /
+                           (1 << 20);
+                });
+
+            if(!result) {
+                return result;
+            }
+        }
+    }
+
+    return {};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Command buffer recording benchmark.
+////////////////////////////////////////////////////////////////////////////////
+
+// Note: Measures the rate of parallel recording of secondary command buffers,
+// each of which contains a number of fill commands.
+auto
+run_recording_benchmark(benchmark_context& context)
+    -> std::expected<void, error> {
+    constexpr auto command_count = 16U;
+
+    auto n = context.parameters.iteration_count;
+    auto worker_count = obtain_worker_count(context.job_pool);
+
+    return measure(
+        context,
+        {.benchmark = "record",
+         .variant = std::to_string(worker_count) + "_workers",
+         .size = command_count,
+         .unit = "cb/s"},
+        [&]() -> std::expected<double, error> {
+            if(auto r = begin(context.recorder, 0); !r) {
+                return std::unexpected{
+                    error{.line = __LINE__, .underlying = r.error()}};
+            }
+
+            auto t0 = clock::now();
+            auto command_buffers = record(
+                context.recorder, context.job_pool,
+                {.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO},
+                0, n, [&](VkCommandBuffer command_buffer, size_t) {
+                    for(auto i = 0U; i != command_count; ++i) {
+                        vkCmdFillBuffer(
+                            command_buffer, context.buffer, 256 * i, 256, i);
+                    }
+                });
+
+            auto t1 = clock::now();
+            if(!command_buffers) {
+                return std::unexpected{error{
+                    .line = __LINE__, .underlying = command_buffers.error()}};
+            }
+
+            return compute_rate(t1 - t0, n);
+        });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Submission benchmarks.
+////////////////////////////////////////////////////////////////////////////////
+
+// Note: Measures the rate of submission of empty command buffers through the
+// scheduler, flushing it after each submission, and after batches of
+// submissions (the scheduler submits each batch with one vkQueueSubmit2 call).
+auto
+run_submission_benchmarks(benchmark_context& context)
+    -> std::expected<void, error> {
+    // Create a command pool.
+    auto command_pool = initialize<vulkan::command_pool>(
+        vkCreateCommandPool, context.device,
+        {.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+         .queueFamilyIndex = context.device.queue_family_index.graphics});
+
+    if(!command_pool) {
+        return std::unexpected{
+            error{.line = __LINE__, .underlying = command_pool.error()}};
+    }
+
+    // Make sure the GPU completes submitted work before the command pool is
+    // destroyed.
+    struct guard {
+        ~guard() {
+            vkDeviceWaitIdle(device);
+        }
+
+        VkDevice device;
+    } _{.device = context.device};
+
+    // Record an empty command buffer, which can be pending multiple times.
+    auto command_buffer = VkCommandBuffer{};
+    if(true) {
+        auto info = VkCommandBufferAllocateInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = *command_pool,
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = 1};
+
+        if(auto code =
+               vkAllocateCommandBuffers(context.device, &info, &command_buffer);
+           code != VK_SUCCESS) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = {__LINE__, code}}};
+        }
+    }
+
+    if(true) {
+        auto info = VkCommandBufferBeginInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT};
+
+        if((vkBeginCommandBuffer(command_buffer, &info) != VK_SUCCESS) ||
+           (vkEndCommandBuffer(command_buffer) != VK_SUCCESS)) {
+            return std::unexpected{error{.line = __LINE__}};
+        }
+    }
+
+    // Measure the rate.
+    auto n = context.parameters.iteration_count;
+    for(auto batch_size : {1U, 16U}) {
+        auto result = measure(
+            context,
+            {.benchmark = "submit",
+             .variant = "batch_" + std::to_string(batch_size),
+             .size = batch_size,
+             .unit = "submit/s"},
+            [&]() -> std::expected<double, error> {
+                auto t0 = clock::now();
+                for(auto i = 0U; i != n; ++i) {
+                    auto point = enqueue(
+                        context.scheduler,
+                        vulkan::work_item{
+                            .queue = vulkan::queue_type::graphics,
+                            .command_buffers = std::span{&command_buffer, 1}});
+
+                    if(!point) {
+                        return std::unexpected{error{
+                            .line = __LINE__, .underlying = point.error()}};
+                    }
+
+                    if(((i + 1) % batch_size) != 0) {
+                        continue;
+                    }
+
+                    if(auto r = flush(context.scheduler); !r) {
+                        return std::unexpected{
+                            error{.line = __LINE__, .underlying = r.error()}};
+                    }
+                }
+
+                // Wait for the GPU, so that the rate includes execution.
+                if(auto r = flush(context.scheduler); !r) {
+                    return std::unexpected{
+                        error{.line = __LINE__, .underlying = r.error()}};
+                }
+
+                if(auto r = wait_idle(context.scheduler); !r) {
+                    return std::unexpected{
+                        error{.line = __LINE__, .underlying = r.error()}};
+                }
+
+                return compute_rate(clock::now() - t0, n);
+            });
+
+        if(!result) {
+            return result;
+        }
+    }
+
+    return {};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Frame loop benchmark.
+////////////////////////////////////////////////////////////////////////////////
+
+// Note: Measures the rate of a swapchain-free frame loop, which renders to an
+// offscreen target with two frames in flight. Each frame waits for the previous
+// use of its image, records a barrier, a clear, and a barrier in parallel, and
+// submits them.
+auto
+run_frame_loop_benchmark(benchmark_context& context)
+    -> std::expected<void, error> {
+    auto extent = VkExtent2D{1280, 720};
+
+    // Initialize offscreen target.
+    auto target = initialize(
+        context.device,
+        vulkan::offscreen_parameters{
+            .format = VK_FORMAT_R8G8B8A8_UNORM,
+            .extent = extent,
+            .image_usage_flags = VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                                 VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+            .image_count = 2});
+
+    if(!target) {
+        return std::unexpected{
+            error{.line = __LINE__, .underlying = target.error()}};
+    }
+
+    // Make sure the GPU completes submitted work before the target is
+    // destroyed.
+    struct guard {
+        ~guard() {
+            vkDeviceWaitIdle(device);
+        }
+
+        VkDevice device;
+    } _{.device = context.device};
+
+    // Initialize image sub-resource range.
+    auto image_subresource_range = VkImageSubresourceRange{
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .baseMipLevel = 0,
+        .levelCount = 1,
+        .baseArrayLayer = 0,
+        .layerCount = 1};
+
+    // Define frame rendering function. Frames in flight correspond to images
+    // of the target.
+    auto completions = std::array<vulkan::timeline_point, 2>{};
+    auto render = [&]() -> std::expected<void, error> {
+        auto i = acquire(*target);
+        auto image = target->targets[i].image.handle;
+
+        if(auto r = wait(context.scheduler, completions[i]); !r) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = r.error()}};
+        }
+
+        if(auto r = begin(context.recorder, i); !r) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = r.error()}};
+        }
+
+        // Record secondary command buffers.
+        auto record_part = [&](VkCommandBuffer command_buffer, size_t j) {
+            if(j == 1) {
+                auto color =
+                    VkClearColorValue{.float32 = {0.5f, 0.5f, 0.1f, 1.0f}};
+
+                vkCmdClearColorImage(
+                    command_buffer, image,
+                    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &color, 1,
+                    &image_subresource_range);
+
+                return;
+            }
+
+            auto is_first = (j == 0);
+            auto barrier = VkImageMemoryBarrier{
+                .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                .srcAccessMask =
+                    (is_first ? VkAccessFlags{}
+                              : VkAccessFlags{VK_ACCESS_TRANSFER_WRITE_BIT}),
+                .dstAccessMask =
+                    (is_first ? VkAccessFlags{VK_ACCESS_TRANSFER_WRITE_BIT}
+                              : VkAccessFlags{VK_ACCESS_TRANSFER_READ_BIT}),
+                .oldLayout = (is_first ? VK_IMAGE_LAYOUT_UNDEFINED
+                                       : VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL),
+                .newLayout = (is_first ? VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
+                                       : VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL),
+                .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                .image = image,
+                .subresourceRange = image_subresource_range};
+
+            vkCmdPipelineBarrier(
+                command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1,
+                &barrier);
+        };
+
+        auto secondaries = record(
+            context.recorder, context.job_pool,
+            {.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO}, 0, 3,
+            record_part);
+
+        if(!secondaries) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = secondaries.error()}};
+        }
+
+        // Execute them in a primary command buffer.
+        auto command_buffer = obtain_primary(context.recorder);
+        if(!command_buffer) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = command_buffer.error()}};
+        }
+
+        auto info = VkCommandBufferBeginInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT};
+
+        if(vkBeginCommandBuffer(*command_buffer, &info) != VK_SUCCESS) {
+            return std::unexpected{error{.line = __LINE__}};
+        }
+
+        vkCmdExecuteCommands(
+            *command_buffer, vulkan::size(*secondaries),
+            vulkan::data(*secondaries));
+
+        if(vkEndCommandBuffer(*command_buffer) != VK_SUCCESS) {
+            return std::unexpected{error{.line = __LINE__}};
+        }
+
+        // Submit the frame.
+        auto point = enqueue(
+            context.scheduler,
+            vulkan::work_item{
+                .queue = vulkan::queue_type::graphics,
+                .command_buffers = std::span{&(*command_buffer), 1}});
+
+        if(!point) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = point.error()}};
+        }
+
+        if(auto r = flush(context.scheduler); !r) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = r.error()}};
+        }
+
+        completions[i] = *point;
+        return {};
+    };
+
+    // Measure the rate.
+    auto n = context.parameters.iteration_count;
+    return measure(
+        context,
+        {.benchmark = "frame_loop",
+         .variant = std::to_string(extent.width) + "x" +
+                    std::to_string(extent.height),
+         .size = VkDeviceSize{4} * extent.width * extent.height,
+         .unit = "frame/s"},
+        [&]() -> std::expected<double, error> {
+            auto t0 = clock::now();
+            for(auto i = 0U; i != n; ++i) {
+                if(auto r = render(); !r) {
+                    return std::unexpected{r.error()};
+                }
+            }
+
+            // Wait for the GPU, so that the rate includes execution.
+            if(auto r = wait_idle(context.scheduler); !r) {
+                return std::unexpected{
+                    error{.line = __LINE__, .underlying = r.error()}};
+            }
+
+            return compute_rate(clock::now() - t0, n);
+        });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Compute benchmarks.
+////////////////////////////////////////////////////////////////////////////////
+
+// Note: Runs the saxpy shader (shaders/saxpy.comp) through the compute
+// dispatcher with four jobs in flight. The dispatch rate is measured with jobs
+// which contain batches of dependent dispatches and no readbacks; the readback
+// bandwidth is measured with jobs which contain one dispatch and read back its
+// result. The benchmarks are skipped if the shader has not been compiled.
+auto
+run_compute_benchmarks(benchmark_context& context)
+    -> std::expected<void, error> {
+    // Skip the benchmarks if the shader is missing.
+    auto const& shader_path = context.parameters.compute_shader_path;
+    if(auto ec = std::error_code{}; !std::filesystem::exists(shader_path, ec)) {
+        std::cerr << "Compute benchmarks skipped: " << shader_path
+                  << " not found.\n";
+        return {};
+    }
+
+    // Create two buffers, allocate their memory from a pool with their
+    // requirements, and bind them. Their contents do not affect the
+    // measurements.
+    constexpr auto element_count = uint32_t{1 << 16};
+    constexpr auto size = VkDeviceSize{sizeof(float) * element_count};
+
+    auto pool = initialize(
+        context.device, vulkan::memory_pool_parameters{.block_size = 4 * size});
+
+    if(!pool) {
+        return std::unexpected{
+            error{.line = __LINE__, .underlying = pool.error()}};
+    }
+
+    vulkan::buffer buffers[2];
+    for(auto& buffer : buffers) {
+        if(auto object = initialize(
+               context.device, vulkan::compute_buffer_parameters{.size = size});
+           !object) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = object.error()}};
+        } else {
+            buffer = std::move(*object);
+        }
+
+        auto requirements = VkMemoryRequirements{};
+        vkGetBufferMemoryRequirements(context.device, buffer, &requirements);
+
+        auto allocation = allocate(
+            *pool, vulkan::memory_allocation_parameters{
+                       .requirements = requirements,
+                       .property_flags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                       .resource_kind = vulkan::memory_resource_kind::linear});
+
+        if(!allocation) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = allocation.error()}};
+        }
+
+        if(auto r = bind(context.device, buffer, *allocation); !r) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = r.error()}};
+        }
+    }
+
+    // Initialize the dispatcher, and the kernel. The pipeline cache is not
+    // stored.
+    auto dispatcher = initialize(
+        context.device, vulkan::compute_dispatcher_parameters{.job_count = 4});
+
+    if(!dispatcher) {
+        return std::unexpected{
+            error{.line = __LINE__, .underlying = dispatcher.error()}};
+    }
+
+    auto cache =
+        initialize(context.device, vulkan::pipeline_cache_parameters{});
+    if(!cache) {
+        return std::unexpected{
+            error{.line = __LINE__, .underlying = cache.error()}};
+    }
+
+    auto kernel = initialize(
+        *dispatcher, *cache,
+        vulkan::compute_kernel_parameters{.shader_path = shader_path});
+
+    if(!kernel) {
+        return std::unexpected{
+            error{.line = __LINE__, .underlying = kernel.error()}};
+    }
+
+    // Make sure the GPU completes submitted work before the resources are
+    // destroyed.
+    struct guard {
+        ~guard() {
+            vkDeviceWaitIdle(device);
+        }
+
+        VkDevice device;
+    } _{.device = context.device};
+
+    // Describe the dispatches, and the readback.
+    struct saxpy_parameters {
+        float a;
+        uint32_t count;
+    } const parameters = {.a = 0.5f, .count = element_count};
+
+    VkBuffer const handles[] = {buffers[0], buffers[1]};
+    auto dispatches = std::vector<vulkan::compute_dispatch>(
+        16, {.kernel = &(*kernel),
+             .buffers = handles,
+             .push_constants = std::as_bytes(std::span{&parameters, 1}),
+             .group_count = {element_count / 64, 1, 1}});
+
+    auto readback = vulkan::compute_readback{
+        .buffer = buffers[1], .offset = 0, .size = size};
+
+    // Submits the given number of jobs, and waits for their results.
+    auto run = [&](vulkan::compute_batch batch,
+                   uint32_t job_count) -> std::expected<void, error> {
+        auto futures = std::vector<vulkan::compute_future>{};
+        futures.reserve(job_count);
+
+        for(auto i = 0U; i != job_count; ++i) {
+            auto future = submit(*dispatcher, batch);
+            if(!future) {
+                return std::unexpected{
+                    error{.line = __LINE__, .underlying = future.error()}};
+            }
+
+            futures.push_back(std::move(*future));
+        }
+
+        for(auto& future : futures) {
+            if(auto r = future.get(); !r) {
+                return std::unexpected{
+                    error{.line = __LINE__, .underlying = r.error()}};
+            }
+        }
+
+        return {};
+    };
+
+    // Measure the dispatch rate.
+    auto n = context.parameters.iteration_count;
+    for(auto batch_size : {1U, 16U}) {
+        auto job_count = std::max(n / batch_size, 1U);
+        auto result = measure(
+            context,
+            {.benchmark = "compute/dispatch",
+             .variant = "batch_" + std::to_string(batch_size),
+             .size = size,
+             .unit = "dispatch/s"},
+            [&]() -> std::expected<double, error> {
+                auto t0 = clock::now();
+                if(auto r = run({.dispatches = std::span{dispatches}.first(
+                                     batch_size)},
+                                job_count);
+                   !r) {
+                    return std::unexpected{r.error()};
+                }
+
+                return compute_rate(clock::now() - t0, job_count * batch_size);
+            });
+
+        if(!result) {
+            return result;
+        }
+    }
+
+    // Measure the readback bandwidth.
+    return measure(
+        context,
+        {.benchmark = "compute/readback",
+         .variant = "batch_1",
+         .size = size,
+         .unit = "MiB/s"},
+        [&]() -> std::expected<double, error> {
+            auto t0 = clock::now();
+            if(auto r =
+                   run({.dispatches = std::span{dispatches}.first(1),
+                        .readbacks = std::span{&readback, 1}},
+                       n);
+               !r) {
+                return std::unexpected{r.error()};
+            }
+
+            return compute_rate(clock::now() - t0, n * size) / (1 << 20);
+        });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Pipeline compilation benchmarks.
+////////////////////////////////////////////////////////////////////////////////
+
+// Note: Measures the rate of background compilation of distinct compute
+// pipelines (descriptions differ by a counter which follows the shader code),
+// and the rate of requests which are satisfied by known pipelines. Each run
+// waits for its compilations.
+auto
+run_compilation_benchmarks(benchmark_context& context)
+    -> std::expected<void, error> {
+    // Skip the benchmarks if the shader is missing.
+    auto const& shader_path = context.parameters.compute_shader_path;
+    if(auto ec = std::error_code{}; !std::filesystem::exists(shader_path, ec)) {
+        std::cerr << "Compilation benchmarks skipped: " << shader_path
+                  << " not found.\n";
+        return {};
+    }
+
+    // Load the shader.
+    auto file = vulkan::map(shader_path);
+    if(!file) {
+        return std::unexpected{
+            error{.line = __LINE__, .underlying = file.error()}};
+    }
+
+    if(auto data = file->data;
+       data.empty() || ((data.size() % sizeof(uint32_t)) != 0)) {
+        return std::unexpected{error{.line = __LINE__}};
+    }
+
+    // Initialize a dispatcher, whose pipeline layout is used by compiled
+    // pipelines, a pipeline cache, which is not stored, and the compiler.
+    auto dispatcher = initialize(
+        context.device, vulkan::compute_dispatcher_parameters{.job_count = 1});
+
+    if(!dispatcher) {
+        return std::unexpected{
+            error{.line = __LINE__, .underlying = dispatcher.error()}};
+    }
+
+    auto cache =
+        initialize(context.device, vulkan::pipeline_cache_parameters{});
+    if(!cache) {
+        return std::unexpected{
+            error{.line = __LINE__, .underlying = cache.error()}};
+    }
+
+    auto compiler = initialize(*cache, vulkan::pipeline_compiler_parameters{});
+    if(!compiler) {
+        return std::unexpected{
+            error{.line = __LINE__, .underlying = compiler.error()}};
+    }
+
+    // Creates a pipeline from the shader code (the function is copied to each
+    // description, and refers to the mapped file, which outlives the compiler).
+    auto code = file->data;
+    auto layout = VkPipelineLayout{dispatcher->pipeline_layout};
+
+    auto create = [code, layout](
+                      vulkan::persistent_pipeline_cache& cache,
+                      VkPipelineCache target)
+        -> std::expected<vulkan::pipeline, vulkan::error> {
+        auto shader = vulkan::initialize<vulkan::shader_module>(
+            vkCreateShaderModule, cache.device,
+            {.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+             .codeSize = code.size(),
+             .pCode = reinterpret_cast<uint32_t const*>(code.data())});
+
+        if(!shader) {
+            return std::unexpected{shader.error()};
+        }
+
+        auto stage = VkPipelineShaderStageCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+            .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+            .module = *shader,
+            .pName = "main"};
+
+        return initialize(
+            cache,
+            VkComputePipelineCreateInfo{
+                .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+                .stage = stage,
+                .layout = layout},
+            target);
+    };
+
+    // Requests compilation of the given number of pipelines, starting from the
+    // given counter, and waits for them.
+    auto content = std::vector<std::byte>(code.size() + sizeof(uint32_t));
+    auto futures = std::vector<vulkan::pipeline_future>{};
+
+    auto run = [&](uint32_t first,
+                   uint32_t count) -> std::expected<void, error> {
+        futures.clear();
+        for(auto i = first; i != first + count; ++i) {
+            std::ranges::copy(code, content.begin());
+            memcpy(content.data() + code.size(), &i, sizeof(i));
+
+            auto future = compile(
+                *compiler,
+                vulkan::pipeline_description{
+                    .content = content, .create = create});
+
+            if(!future) {
+                return std::unexpected{
+                    error{.line = __LINE__, .underlying = future.error()}};
+            }
+
+            futures.push_back(std::move(*future));
+        }
+
+        for(auto const& future : futures) {
+            auto status = poll(future);
+            for(; status == vulkan::compilation_status::pending;
+                status = poll(future)) {
+                std::this_thread::yield();
+            }
+
+            if(status == vulkan::compilation_status::failed) {
+                return std::unexpected{error{.line = __LINE__}};
+            }
+        }
+
+        return {};
+    };
+
+    // Measure the rate of compilation.
+    auto n = std::min(context.parameters.iteration_count, 64U);
+    auto counter = uint32_t{};
+
+    auto result = measure(
+        context,
+        {.benchmark = "compile",
+         .variant = "distinct",
+         .size = n,
+         .unit = "pipeline/s"},
+        [&]() -> std::expected<double, error> {
+            auto t0 = clock::now();
+            if(auto r = run(counter, n); !r) {
+                return std::unexpected{r.error()};
+            }
+
+            counter += n;
+            return compute_rate(clock::now() - t0, n);
+        });
+
+    if(!result) {
+        return result;
+    }
+
+    // Measure the rate of deduplicated requests.
+    return measure(
+        context,
+        {.benchmark = "compile",
+         .variant = "deduplicated",
+         .size = n,
+         .unit = "request/s"},
+        [&]() -> std::expected<double, error> {
+            auto t0 = clock::now();
+            if(auto r = run(0, n); !r) {
+                return std::unexpected{r.error()};
+            }
+
+            return compute_rate(clock::now() - t0, n);
+        });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Culling benchmark.
+////////////////////////////////////////////////////////////////////////////////
+
+// Note: Measures the rate of GPU-driven culling of instances which are spread
+// around the view volume, so that a part of them is visible. Instances
+// are uploaded through staging once. Each run submits a culling pass per
+// iteration, and waits for the GPU.
+auto
+run_culling_benchmark(benchmark_context& context)
+    -> std::expected<void, error> {
+    constexpr auto instance_count = uint32_t{1 << 16};
+    constexpr auto bucket_count = uint32_t{16};
+
+    // Skip the benchmark if the shader is missing.
+    auto const& shader_path = context.parameters.culling_shader_path;
+    if(auto ec = std::error_code{}; !std::filesystem::exists(shader_path, ec)) {
+        std::cerr << "Culling benchmark skipped: " << shader_path
+                  << " not found.\n";
+        return {};
+    }
+
+    // Initialize the culling stage. The pipeline cache is not stored.
+    auto cache =
+        initialize(context.device, vulkan::pipeline_cache_parameters{});
+    if(!cache) {
+        return std::unexpected{
+            error{.line = __LINE__, .underlying = cache.error()}};
+    }
+
+    auto capacities = std::vector<uint32_t>(
+        bucket_count, instance_count / bucket_count);
+
+    auto stage = initialize(
+        context.device, *cache,
+        vulkan::culling_parameters{
+            .shader_path = shader_path, .bucket_capacities = capacities});
+
+    if(!stage) {
+        return std::unexpected{
+            error{.line = __LINE__, .underlying = stage.error()}};
+    }
+
+    // Create a command pool.
+    auto command_pool = initialize<vulkan::command_pool>(
+        vkCreateCommandPool, context.device,
+        {.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+         .queueFamilyIndex = context.device.queue_family_index.graphics});
+
+    if(!command_pool) {
+        return std::unexpected{
+            error{.line = __LINE__, .underlying = command_pool.error()}};
+    }
+
+    // Initialize staging.
+    auto staging = initialize(
+        context.device,
+        vulkan::staging_parameters{
+            .capacity = sizeof(vulkan::culling_instance) * instance_count,
+            .batch_count = 1,
+            .destination_queue_family_index =
+                context.device.queue_family_index.graphics});
+
+    if(!staging) {
+        return std::unexpected{
+            error{.line = __LINE__, .underlying = staging.error()}};
+    }
+
+    // Make sure the GPU completes submitted work before the resources are
+    // destroyed.
+    struct guard {
+        ~guard() {
+            vkDeviceWaitIdle(device);
+        }
+
+        VkDevice device;
+    } _{.device = context.device};
+
+    // Upload the instances.
+    auto submission = vulkan::staging_submission{};
+    if(auto instances = std::vector<vulkan::culling_instance>(instance_count);
+       true) {
+        auto generator = std::minstd_rand{};
+        auto distribution = std::uniform_real_distribution<float>{-2.0f, 2.0f};
+
+        for(auto i = 0U; auto& x : instances) {
+            x = {.center = {distribution(generator), distribution(generator),
+                            distribution(generator)},
+                 .radius = 0.05f,
+                 .index_count = 36,
+                 .bucket = (i++ % bucket_count)};
+        }
+
+        if(auto r = upload(
+               *staging, std::as_bytes(std::span{instances}),
+               vulkan::staging_buffer_target{
+                   .buffer = stage->instances.buffer,
+                   .access_mask = VK_ACCESS_SHADER_READ_BIT});
+           !r) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = r.error()}};
+        }
+
+        if(auto r = submit(*staging, true); !r) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = r.error()}};
+        } else {
+            submission = *r;
+        }
+    }
+
+    // Record two command buffers: the first one acquires the instances, and
+    // culls them once, and the second one, which can be pending multiple
+    // times, culls them.
+    VkCommandBuffer command_buffers[2] = {};
+    if(true) {
+        auto info = VkCommandBufferAllocateInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = *command_pool,
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = 2};
+
+        if(auto code =
+               vkAllocateCommandBuffers(context.device, &info, command_buffers);
+           code != VK_SUCCESS) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = {__LINE__, code}}};
+        }
+    }
+
+    float const view_projection[16] = {
+        1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+
+    auto frustum = vulkan::compute_frustum(view_projection);
+
+    for(auto i = 0U; i != 2; ++i) {
+        auto info = VkCommandBufferBeginInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT};
+
+        if(vkBeginCommandBuffer(command_buffers[i], &info) != VK_SUCCESS) {
+            return std::unexpected{error{.line = __LINE__}};
+        }
+
+        if(i == 0) {
+            record_acquisition(
+                submission, command_buffers[i],
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+        }
+
+        record_culling(*stage, command_buffers[i], frustum, instance_count);
+
+        if(vkEndCommandBuffer(command_buffers[i]) != VK_SUCCESS) {
+            return std::unexpected{error{.line = __LINE__}};
+        }
+    }
+
+    // Submit the first command buffer after the upload.
+    if(true) {
+        VkSemaphoreSubmitInfo waits[] = {
+            {.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+             .semaphore = submission.semaphore,
+             .stageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT}};
+
+        auto point = enqueue(
+            context.scheduler,
+            vulkan::work_item{
+                .queue = vulkan::queue_type::graphics,
+                .command_buffers = std::span{command_buffers}.first(1),
+                .waits = waits});
+
+        if(!point) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = point.error()}};
+        }
+
+        if(auto r = flush(context.scheduler); !r) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = r.error()}};
+        }
+    }
+
+    // Measure the rate.
+    auto n = context.parameters.iteration_count;
+    return measure(
+        context,
+        {.benchmark = "cull",
+         .variant = std::to_string(bucket_count) + "_buckets",
+         .size = instance_count,
+         .unit = "instance/s"},
+        [&]() -> std::expected<double, error> {
+            auto t0 = clock::now();
+            for(auto i = 0U; i != n; ++i) {
+                auto point = enqueue(
+                    context.scheduler,
+                    vulkan::work_item{
+                        .queue = vulkan::queue_type::graphics,
+                        .command_buffers = std::span{command_buffers}.last(1)});
+
+                if(!point) {
+                    return std::unexpected{
+                        error{.line = __LINE__, .underlying = point.error()}};
+                }
+            }
+
+            if(auto r = flush(context.scheduler); !r) {
+                return std::unexpected{
+                    error{.line = __LINE__, .underlying = r.error()}};
+            }
+
+            if(auto r = wait_idle(context.scheduler); !r) {
+                return std::unexpected{
+                    error{.line = __LINE__, .underlying = r.error()}};
+            }
+
+            return compute_rate(
+                clock::now() - t0, static_cast<double>(n) * instance_count);
+        });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Texture streaming benchmark.
+////////////////////////////////////////////////////////////////////////////////
+
+// Note: Generates a KTX2 container which holds the full mip chain of a square
+// RGBA8 texture with zero texels.
+auto
+generate_ktx2(uint32_t width) -> std::vector<std::byte> {
+    constexpr auto header_size = size_t{80};
+    constexpr auto level_entry_size = size_t{24};
+
+    static constexpr unsigned char identifier[] = {
+        0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+    // Compute the size of the container.
+    auto level_count = static_cast<uint32_t>(std::bit_width(width));
+    auto offset = uint64_t{header_size + level_count * level_entry_size};
+
+    auto size = offset;
+    for(auto i = 0U; i != level_count; ++i) {
+        size += uint64_t{4} * (width >> i) * (width >> i);
+    }
+
+    // Write the header and the level index.
+    auto result = std::vector<std::byte>(static_cast<size_t>(size));
+    auto write = [&](size_t position, auto x) {
+        memcpy(result.data() + position, &x, sizeof(x));
+    };
+
+    memcpy(result.data(), identifier, sizeof(identifier));
+    write(12, static_cast<uint32_t>(VK_FORMAT_R8G8B8A8_UNORM));
+    write(16, uint32_t{1}); // Type size.
+    write(20, width);       // Width.
+    write(24, width);       // Height.
+    write(36, uint32_t{1}); // Face count.
+    write(40, level_count);
+
+    for(auto i = 0U; i != level_count; ++i) {
+        auto entry = header_size + i * level_entry_size;
+        auto level_size = uint64_t{4} * (width >> i) * (width >> i);
+
+        write(entry, offset);
+        write(entry + 8, level_size);
+        write(entry + 16, level_size);
+
+        offset += level_size;
+    }
+
+    return result;
+}
+
+// Note: Measures the bandwidth of streaming of a texture from the given KTX2
+// file to full residency. Each run opens the file as a new texture, requests
+// its finest level, and renders frames which apply updates of the streamer
+// until the finest level is resident. Textures of previous runs are reduced
+// meanwhile. Frames wait for the GPU, so replaced images are retired at empty
+// points, and are collected after the wait.
+auto
+measure_streaming(
+    benchmark_context& context, std::filesystem::path const& path,
+    VkDeviceSize size) -> std::expected<void, error> {
+    // Initialize the streamer.
+    auto streamer = initialize(
+        context.device,
+        vulkan::texture_streamer_parameters{
+            .staging =
+                {.capacity = 1 << 24,
+                 .batch_count = 4,
+                 .destination_queue_family_index =
+                     context.device.queue_family_index.graphics},
+            .budget = VkDeviceSize{1} << 28,
+            .tail_level_count = 1,
+            .pass_interval = std::chrono::milliseconds{1}});
+
+    if(!streamer) {
+        return std::unexpected{
+            error{.line = __LINE__, .underlying = streamer.error()}};
+    }
+
+    // Create a command pool, and allocate a command buffer which is reused by
+    // frames.
+    auto command_pool = initialize<vulkan::command_pool>(
+        vkCreateCommandPool, context.device,
+        {.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+         .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+         .queueFamilyIndex = context.device.queue_family_index.graphics});
+
+    if(!command_pool) {
+        return std::unexpected{
+            error{.line = __LINE__, .underlying = command_pool.error()}};
+    }
+
+    auto command_buffer = VkCommandBuffer{};
+    if(true) {
+        auto info = VkCommandBufferAllocateInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool = *command_pool,
+            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+            .commandBufferCount = 1};
+
+        if(auto code =
+               vkAllocateCommandBuffers(context.device, &info, &command_buffer);
+           code != VK_SUCCESS) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = {__LINE__, code}}};
+        }
+    }
+
+    // Make sure the GPU completes submitted work before the resources are
+    // destroyed.
+    struct guard {
+        ~guard() {
+            vkDeviceWaitIdle(device);
+        }
+
+        VkDevice device;
+    } _{.device = context.device};
+
+    // Define frame rendering function.
+    auto render = [&]() -> std::expected<void, error> {
+        auto info = VkCommandBufferBeginInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT};
+
+        if(vkBeginCommandBuffer(command_buffer, &info) != VK_SUCCESS) {
+            return std::unexpected{error{.line = __LINE__}};
+        }
+
+        if(auto r = update(
+               *streamer, context.device, command_buffer,
+               VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, {});
+           !r) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = r.error()}};
+        }
+
+        if(vkEndCommandBuffer(command_buffer) != VK_SUCCESS) {
+            return std::unexpected{error{.line = __LINE__}};
+        }
+
+        auto point = enqueue(
+            context.scheduler,
+            vulkan::work_item{
+                .queue = vulkan::queue_type::graphics,
+                .command_buffers = std::span{&command_buffer, 1}});
+
+        if(!point) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = point.error()}};
+        }
+
+        if(auto r = flush(context.scheduler); !r) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = r.error()}};
+        }
+
+        if(auto r = wait_idle(context.scheduler); !r) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = r.error()}};
+        }
+
+        if(auto r = collect(context.device); !r) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = r.error()}};
+        }
+
+        return {};
+    };
+
+    // Measure the bandwidth.
+    return measure(
+        context,
+        {.benchmark = "stream",
+         .variant = "ktx2",
+         .size = size,
+         .unit = "MiB/s"},
+        [&]() -> std::expected<double, error> {
+            auto t0 = clock::now();
+
+            auto id = open(*streamer, path);
+            if(!id) {
+                return std::unexpected{
+                    error{.line = __LINE__, .underlying = id.error()}};
+            }
+
+            for(auto texture = vulkan::streamed_texture{};
+                (texture.view == nullptr) || (texture.first_level != 0);
+                texture = obtain_texture(*streamer, *id)) {
+                request(*streamer, *id, 0);
+                if(auto r = render(); !r) {
+                    return std::unexpected{r.error()};
+                }
+            }
+
+            return compute_rate(clock::now() - t0, size) / (1 << 20);
+        });
+}
+
+// Note: The streamer submits to the first queue of the transfer role (the queue
+// which staging obtains) from its own thread, so the benchmark is skipped if
+// that queue is also the graphics queue, which the frame loop uses.
+auto
+run_streaming_benchmark(benchmark_context& context)
+    -> std::expected<void, error> {
+    if(auto queues = obtain_queue_list(context.device);
+       queues.transfer == queues.graphics) {
+        std::cerr << "Streaming benchmark skipped: the transfer queue is not "
+                     "distinct.\n";
+        return {};
+    }
+
+    // Store the texture in a temporary file.
+    auto ec = std::error_code{};
+    auto path = std::filesystem::temp_directory_path(ec);
+    if(ec) {
+        return std::unexpected{error{.line = __LINE__}};
+    }
+
+    path /= "rose_benchmark.ktx2";
+
+    auto data = generate_ktx2(1024);
+    if(auto r = vulkan::store(path, std::as_bytes(std::span{data})); !r) {
+        return std::unexpected{
+            error{.line = __LINE__, .underlying = r.error()}};
+    }
+
+    // Measure the bandwidth, and remove the file.
+    auto result = measure_streaming(context, path, data.size());
+    std::filesystem::remove(path, ec);
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Result formatting functions.
+////////////////////////////////////////////////////////////////////////////////
+
+void
+append_string(std::string& string, std::string_view x) {
+    string += '"';
+    for(auto c : x) {
+        if((c == '"') || (c == '\\')) {
+            string += '\\';
+        }
+
+        string += c;
+    }
+
+    string += '"';
+}
+
+auto
+format_json(benchmark_context const& context) -> std::string {
+    auto const& properties = context.physical_device.properties;
+    auto result = std::string{};
+
+    // Describe the device and the parameters.
+    result += "{\"device\":";
+    append_string(result, properties.deviceName);
+    result += ",\"driver_version\":" + std::to_string(properties.driverVersion);
+    result += ",\"run_count\":" + std::to_string(context.parameters.run_count);
+    result += ",\"instruction_set\":";
+    append_string(
+        result, obtain_instruction_set_name(vulkan::obtain_instruction_set()));
+
+    result += ",\"results\":[";
+
+    // Describe the measurements.
+    for(auto i = 0zU; auto const& x : context.measurements) {
+        auto summary = summarize(x.samples);
+
+        result += ((i++ != 0) ? ",\n{\"benchmark\":" : "\n{\"benchmark\":");
+        append_string(result, x.benchmark);
+        result += ",\"variant\":";
+        append_string(result, x.variant);
+        result += ",\"size\":" + std::to_string(x.size);
+        result += ",\"unit\":";
+        append_string(result, x.unit);
+
+        result += ",\"samples\":[";
+        for(auto j = 0zU; j != x.samples.size(); ++j) {
+            result += ((j != 0) ? "," : "") + std::to_string(x.samples[j]);
+        }
+
+        result += "],\"mean\":" + std::to_string(summary.mean);
+        result += ",\"standard_deviation\":" +
+                  std::to_string(summary.standard_deviation);
+        result += ",\"min\":" + std::to_string(summary.min);
+        result += ",\"max\":" + std::to_string(summary.max) + "}";
+    }
+
+    result += "\n]}\n";
+    return result;
+}
+
+auto
+format_csv(benchmark_context const& context) -> std::string {
+    auto result = std::string{
+        "benchmark,variant,size,unit,run_count,mean,standard_deviation,"
+        "coefficient_of_variation,min,max\n"};
+
+    for(auto const& x : context.measurements) {
+        auto summary = summarize(x.samples);
+        auto coefficient_of_variation =
+            ((summary.mean != 0.0) ? (summary.standard_deviation / summary.mean)
+                                   : 0.0);
+
+        result += x.benchmark + "," + x.variant + "," +
+                  std::to_string(x.size) + "," + x.unit + "," +
+                  std::to_string(x.samples.size()) + "," +
+                  std::to_string(summary.mean) + "," +
+                  std::to_string(summary.standard_deviation) + "," +
+                  std::to_string(coefficient_of_variation) + "," +
+                  std::to_string(summary.min) + "," +
+                  std::to_string(summary.max) + "\n";
+    }
+
+    return result;
+}
+
+} // namespace rose
+
+////////////////////////////////////////////////////////////////////////////////
+// Program entry point.
+////////////////////////////////////////////////////////////////////////////////
+
+int
+main(int argc, char* argv[]) {
+    // Parse command line arguments.
+    auto parameters = rose::benchmark_parameters{
+        .run_count = 5,
+        .iteration_count = 256,
+        .transfer_size = 1 << 26,
+        .compute_shader_path = "saxpy.spv",
+        .culling_shader_path = "culling.spv"};
+
+    auto is_csv = false;
+    auto output_path = std::filesystem::path{};
+
+    // Note: Counts must be positive decimal numbers.
+    auto parse_count = [](std::string_view value, uint32_t& count) {
+        auto [end, code] = std::from_chars(
+            value.data(), value.data() + value.size(), count);
+
+        return (code == std::errc{}) &&
+               (end == (value.data() + value.size())) && (count != 0);
+    };
+
+    auto is_valid = true;
+    for(auto i = 1; is_valid && (i < argc); ++i) {
+        auto argument = std::string_view{argv[i]};
+        if((argument == "--format") && ((i + 1) < argc)) {
+            auto format = std::string_view{argv[++i]};
+            is_csv = (format == "csv");
+            is_valid = is_csv || (format == "json");
+        } else if((argument == "--output") && ((i + 1) < argc)) {
+            output_path = argv[++i];
+        } else if((argument == "--runs") && ((i + 1) < argc)) {
+            is_valid = parse_count(argv[++i], parameters.run_count);
+        } else if((argument == "--iterations") && ((i + 1) < argc)) {
+            is_valid = parse_count(argv[++i], parameters.iteration_count);
+        } else if((argument == "--compute-shader") && ((i + 1) < argc)) {
+            parameters.compute_shader_path = argv[++i];
+        } else if((argument == "--culling-shader") && ((i + 1) < argc)) {
+            parameters.culling_shader_path = argv[++i];
+        } else {
+            is_valid = false;
+        }
+    }
+
+    // Print usage on invalid arguments.
+    if(!is_valid) {
+        std::cout << "Usage: benchmark [--format json|csv] "
+                     "[--output PATH] [--runs N] [--iterations N] "
+                     "[--compute-shader PATH] [--culling-shader PATH]\n";
+        return EXIT_FAILURE;
+    }
+
+    // Initialize benchmark context.
+    auto context = rose::initialize_benchmark_context(parameters);
+    if(!context) {
+        std::cout << "Benchmark context initialization failed.\n";
+        return EXIT_FAILURE;
+    }
+
+    // Run the benchmarks.
+    std::expected<void, rose::error> (*benchmarks[])(
+        rose::benchmark_context&) = {
+        rose::run_allocation_benchmarks, rose::run_transfer_benchmarks,
+        rose::run_staging_benchmarks, rose::run_copy_benchmarks,
+        rose::run_recording_benchmark, rose::run_submission_benchmarks,
+        rose::run_frame_loop_benchmark, rose::run_compute_benchmarks,
+        rose::run_compilation_benchmarks, rose::run_culling_benchmark,
+        rose::run_streaming_benchmark};
+
+    for(auto benchmark : benchmarks) {
+        if(auto result = benchmark(*context); !result) {
+            std::cout << "Benchmark failed (line " << result.error().line
+                      << ").\n";
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Store the results.
+    auto results = (is_csv ? rose::format_csv(*context)
+                           : rose::format_json(*context));
+
+    if(output_path.empty()) {
+        std::cout << results;
+    } else if(!rose::vulkan::store(
+                  output_path, std::as_bytes(std::span{results}))) {
+        std::cout << "Failed to store the results.\n";
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
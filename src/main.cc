@@ -8,7 +8,17 @@
 #include <SDL_vulkan.h>
 #include <vulkan/vulkan.h>
 
+import rose.vulkan.descriptors;
 import rose.vulkan.device;
+import rose.vulkan.graph;
+import rose.vulkan.handoff;
+import rose.vulkan.offscreen;
+import rose.vulkan.pacing;
+import rose.vulkan.pipeline;
+import rose.vulkan.profiler;
+import rose.vulkan.recording;
+import rose.vulkan.scheduler;
+import rose.vulkan.selection;
 import rose.vulkan.swapchain;
 
 namespace rose {
@@ -39,12 +49,104 @@ using window_deleter = decltype([](SDL_Window* window) {
 
 using window = std::unique_ptr<SDL_Window, detail::window_deleter>;
 
+////////////////////////////////////////////////////////////////////////////////
+// Input event definition.
+////////////////////////////////////////////////////////////////////////////////
+
+struct input_event {
+    using clock = std::chrono::steady_clock;
+
+    // Type of the SDL event.
+    uint32_t type;
+
+    // Sequence number of the event, and the time it was received.
+    uint64_t sequence;
+    clock::time_point time;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Frame state definition.
+////////////////////////////////////////////////////////////////////////////////
+
+struct frame_state {
+    // Color which the frame is cleared with.
+    VkClearColorValue color;
+
+    // Sequence number of the last input event which is reflected by the state.
+    uint64_t input_sequence;
+
+    // Size of the window, and refresh rate of its display (zero if unknown).
+    // SDL's window functions are called by the event thread only, so the
+    // render thread obtains them through the state.
+    VkExtent2D window_extent;
+    uint32_t refresh_rate;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Simulation state definition.
+////////////////////////////////////////////////////////////////////////////////
+
+struct simulation {
+    // Pointer position in window coordinates (normalized to [0, 1]).
+    float x, y;
+
+    // Sequence number of the last received input event.
+    uint64_t input_sequence;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Thread handoff definition.
+////////////////////////////////////////////////////////////////////////////////
+
+// Note: The event thread (the main thread, since SDL requires it) receives
+// input and runs the simulation; the render thread renders the latest frame
+// state. Input events and frame states are passed without locks.
+struct handoff {
+    // Input events, and frame states.
+    vulkan::spsc_queue<input_event> events;
+    vulkan::triple_buffer<frame_state> frames;
+
+    // Flag which is cleared when the program should stop.
+    std::atomic<bool> is_running;
+
+    // Number of input events which were dropped because the queue was full
+    // (accessed by the event thread only).
+    uint64_t dropped_event_count;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Latency history definition.
+////////////////////////////////////////////////////////////////////////////////
+
+// Note: Ring of recent input-to-present latencies: from the time an input
+// event is received to the time the first frame which reflects it is queued
+// for presentation.
+struct latency_history {
+    std::vector<std::chrono::nanoseconds> samples;
+    size_t count;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Main context initialization parameters definition.
+////////////////////////////////////////////////////////////////////////////////
+
+struct main_parameters {
+    // Number of frames in flight.
+    uint32_t frame_count;
+
+    // Extent of offscreen images, and the flag which enables their read-back
+    // (headless mode only).
+    VkExtent2D extent;
+    bool is_readback_enabled;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 // Main context definition.
 ////////////////////////////////////////////////////////////////////////////////
 
 struct main_context {
-    // Window.
+    // Window. If there is no window, then the context is headless: it renders
+    // to offscreen images instead of a swapchain.
     SDL_Window* window;
 
     // Instance and selected physical device.
@@ -59,29 +161,107 @@ struct main_context {
     vulkan::device device;
     vulkan::queue_list device_queues;
 
-    // Semaphores.
-    struct {
-        vulkan::semaphore rendering, swapchain;
-    } semaphores;
+    // Submission scheduler.
+    vulkan::scheduler scheduler;
 
-    // Command pool and command buffers.
-    vulkan::command_pool command_pool;
-    std::array<VkCommandBuffer, 16> command_buffers;
+    // Pipeline cache which persists between runs.
+    vulkan::persistent_pipeline_cache pipeline_cache;
+
+    // Bindless descriptor heap.
+    vulkan::descriptor_heap descriptor_heap;
+
+    // Frames in flight: the CPU records the next frame while the GPU executes
+    // the previous ones.
+    struct frame {
+        // Timeline point which is reached when the frame's commands complete.
+        vulkan::timeline_point completion;
+
+        // Semaphore which is signaled when a swapchain image is acquired.
+        vulkan::semaphore swapchain;
+    };
+
+    std::vector<frame> frames;
+    size_t frame_index;
+
+    // Job pool, and command buffer recorder which uses it.
+    vulkan::job_pool job_pool;
+    vulkan::recorder recorder;
+
+    // Render graph which is declared every frame.
+    vulkan::render_graph graph;
 
     // Swapchain and its initialization parameters.
     vulkan::swapchain swapchain;
     vulkan::swapchain_parameters swapchain_parameters;
 
-    // Array of swapchain images.
+    // Offscreen target (headless mode only).
+    vulkan::offscreen_target offscreen;
+
+    // Array of swapchain images (or offscreen images in headless mode).
     std::vector<VkImage> swapchain_images;
+
+    // Semaphores which are signaled when rendering to swapchain images
+    // completes.
+    std::vector<vulkan::semaphore> rendering_semaphores;
+
+    // Rendering semaphores of previous swapchains. The presentation engine
+    // may still wait on them, so they are retired with the first frame which
+    // acquires an image from the current swapchain.
+    std::vector<vulkan::semaphore> old_rendering_semaphores;
+
+    // Frame pacer.
+    vulkan::pacer pacer;
+
+    // GPU and CPU profiler.
+    vulkan::profiler profiler;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+// Window query functions.
+////////////////////////////////////////////////////////////////////////////////
+
+// Note: Must be called by the event thread.
+auto
+obtain_window_extent(SDL_Window* window) -> VkExtent2D {
+    auto width = 0, height = 0;
+    SDL_GetWindowSize(window, &width, &height);
+
+    return {
+        .width = static_cast<uint32_t>(std::max(width, 0)),
+        .height = static_cast<uint32_t>(std::max(height, 0))};
+}
+
+// Note: Must be called by the event thread. Returns zero if the refresh rate
+// of the window's display is unknown.
+auto
+obtain_refresh_rate(SDL_Window* window) -> uint32_t {
+    auto mode = SDL_DisplayMode{};
+    if((SDL_GetWindowDisplayMode(window, &mode) != 0) ||
+       (mode.refresh_rate <= 0)) {
+        return 0;
+    }
+
+    return static_cast<uint32_t>(mode.refresh_rate);
+}
+
+// Note: Unknown refresh rate is assumed to be 60 Hz.
+auto
+compute_frame_duration(uint32_t refresh_rate) -> std::chrono::nanoseconds {
+    return std::chrono::nanoseconds{1'000'000'000} /
+           ((refresh_rate != 0) ? refresh_rate : 60U);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Vulkan extension query functions.
 ////////////////////////////////////////////////////////////////////////////////
 
 auto
 obtain_instance_extensions(SDL_Window* window) -> std::vector<char const*> {
+    // Headless context does not need any extensions.
+    if(window == nullptr) {
+        return {};
+    }
+
     auto n = unsigned{};
     if(SDL_Vulkan_GetInstanceExtensions(window, &n, nullptr) != SDL_TRUE) {
         return {};
@@ -97,156 +277,218 @@ obtain_instance_extensions(SDL_Window* window) -> std::vector<char const*> {
 }
 
 auto
-obtain_device_extensions() -> std::vector<char const*> {
+obtain_device_extensions(SDL_Window* window) -> std::vector<char const*> {
+    if(window == nullptr) {
+        return {};
+    }
+
     return {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Command buffers construction function.
+// Frame recording function.
 ////////////////////////////////////////////////////////////////////////////////
 
 auto
-construct_command_buffers(main_context& context) -> std::expected<void, error> {
-    // Reset command pool.
-    if(vkResetCommandPool(context.device, context.command_pool, 0) !=
-       VK_SUCCESS) {
+record_frame(
+    main_context& context, frame_state const& state, uint32_t image_index)
+    -> std::expected<VkCommandBuffer, error> {
+    // Start recording of the current frame.
+    if(!begin(context.recorder, context.frame_index)) {
         return std::unexpected{error{.line = __LINE__}};
     }
 
-    // Obtain queue family index.
+    // Obtain queue family index and the image.
     auto queue_family_index = context.device.queue_family_index;
+    auto image = context.swapchain_images[image_index];
+    auto is_headless = (context.window == nullptr);
+
+    // Declare the frame's render graph. Offscreen images are prepared for
+    // read-back instead of presentation.
+    // Note: The image is cleared, so its previous contents are discarded, and
+    // the swapchain semaphore is waited for at the transfer stage.
+    auto& graph = context.graph;
+    begin(graph);
+
+    auto target = import_image(
+        graph, vulkan::graph_image_parameters{
+                   .image = image,
+                   .range = {.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                             .levelCount = 1,
+                             .layerCount = 1},
+                   .initial_usage = vulkan::resource_usage::none,
+                   .final_usage =
+                       (is_headless ? vulkan::resource_usage::transfer_source
+                                    : vulkan::resource_usage::present),
+                   .final_queue_family_index =
+                       (is_headless ? queue_family_index.graphics
+                                    : queue_family_index.presentation)});
+
+    if(!target) {
+        return std::unexpected{
+            error{.line = __LINE__, .underlying = target.error()}};
+    }
 
-    // Record command buffers for all swapchain images.
-    auto command_buffers = std::span{context.command_buffers}.first(std::min(
-        context.swapchain_images.size(), context.command_buffers.size()));
-
-    for(auto i = 0zU; auto command_buffer : command_buffers) {
-        // Initialize image sub-resource range.
-        auto image_subresource_range = VkImageSubresourceRange{
-            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-            .baseMipLevel = 0,
-            .levelCount = 1,
-            .baseArrayLayer = 0,
-            .layerCount = 1};
-
-        // Begin recording.
-        if(true) {
-            auto info = VkCommandBufferBeginInfo{
-                .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
-
-            if(vkBeginCommandBuffer(command_buffer, &info) != VK_SUCCESS) {
-                return std::unexpected{error{.line = __LINE__}};
-            }
+    if(true) {
+        vulkan::graph_access accesses[] = {
+            {.resource = *target,
+             .usage = vulkan::resource_usage::transfer_destination}};
+
+        auto pass = add_pass(
+            graph,
+            {.name = "clear",
+             .accesses = accesses,
+             .record = [&graph, target = *target, color = state.color](
+                           VkCommandBuffer command_buffer) {
+                 auto range = VkImageSubresourceRange{
+                     .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                     .levelCount = 1,
+                     .layerCount = 1};
+
+                 vkCmdClearColorImage(
+                     command_buffer, obtain_image(graph, target),
+                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &color, 1,
+                     &range);
+             }});
+
+        if(!pass) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = pass.error()}};
+        }
+    }
+
+    // Compile the graph. Compilation is skipped while the topology of the
+    // graph does not change.
+    if(auto point = obtain_last_point(
+           context.scheduler, vulkan::queue_type::graphics);
+       true) {
+        auto status = compile(
+            graph, context.device,
+            {.semaphore = point.semaphore, .value = point.value});
+
+        if(!status) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = status.error()}};
         }
+    }
 
-        // Add pipeline barrier.
-        if(true) {
-            VkImageMemoryBarrier barriers[] = {
-                {.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-                 .srcAccessMask = VK_ACCESS_MEMORY_READ_BIT,
-                 .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
-                 .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-                 .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                 .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                 .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                 .image = context.swapchain_images[i],
-                 .subresourceRange = image_subresource_range}};
-
-            vkCmdPipelineBarrier(
-                command_buffer,
-                // Stage masks, dependency flags.
-                VK_PIPELINE_STAGE_TRANSFER_BIT, // Source stage.
-                VK_PIPELINE_STAGE_TRANSFER_BIT, // Destination stage.
-                0,                              // Dependency flags.
-                // Global memory barriers.
-                0, nullptr,
-                // Buffer memory barriers.
-                0, nullptr,
-                // Image memory barriers.
-                vulkan::size(std::span{barriers}), barriers);
-        }
-
-        // Clear the image.
-        if(auto color = VkClearColorValue{.float32 = {0.5f, 0.5f, 0.1f, 1.0f}};
-           true) {
-            vkCmdClearColorImage(
-                command_buffer, context.swapchain_images[i],
-                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &color, 1,
-                &image_subresource_range);
-        }
-
-        // Add pipeline barrier.
-        if(true) {
-            VkImageMemoryBarrier barriers[] = {
-                {.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
-                 .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
-                 .dstAccessMask = 0,
-                 .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                 .newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
-                 .srcQueueFamilyIndex = queue_family_index.graphics,
-                 .dstQueueFamilyIndex = queue_family_index.presentation,
-                 .image = context.swapchain_images[i],
-                 .subresourceRange = image_subresource_range}};
-
-            vkCmdPipelineBarrier(
-                command_buffer,
-                // Stage masks, dependency flags.
-                VK_PIPELINE_STAGE_TRANSFER_BIT,       // Source stage.
-                VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, // Destination stage.
-                0,                                    // Dependency flags.
-                // Global memory barriers.
-                0, nullptr,
-                // Buffer memory barriers.
-                0, nullptr,
-                // Image memory barriers.
-                vulkan::size(std::span{barriers}), barriers);
-        }
-
-        // End recording.
-        if(vkEndCommandBuffer(command_buffer) != VK_SUCCESS) {
+    // Record passes to secondary command buffers in parallel. Each task
+    // records a pass with the barriers which precede it; the parts are
+    // executed in the order of passes.
+    auto record_part = [&](VkCommandBuffer command_buffer, size_t i) {
+        execute(graph, command_buffer, static_cast<uint32_t>(i));
+    };
+
+    auto secondaries = record(
+        context.recorder, context.job_pool,
+        {.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO}, 0,
+        graph.passes.size(), record_part);
+
+    if(!secondaries) {
+        return std::unexpected{
+            error{.line = __LINE__, .underlying = secondaries.error()}};
+    }
+
+    // Stitch secondary command buffers together in a primary command buffer.
+    auto command_buffer = obtain_primary(context.recorder);
+    if(!command_buffer) {
+        return std::unexpected{
+            error{.line = __LINE__, .underlying = command_buffer.error()}};
+    }
+
+    if(true) {
+        auto info = VkCommandBufferBeginInfo{
+            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+            .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT};
+
+        if(vkBeginCommandBuffer(*command_buffer, &info) != VK_SUCCESS) {
             return std::unexpected{error{.line = __LINE__}};
         }
+    }
 
-        i++;
+    // Execute the secondary command buffers, measuring each of them.
+    begin_frame(context.profiler, context.frame_index, *command_buffer);
+
+    if(true) {
+        for(auto i = 0zU; auto secondary : *secondaries) {
+            auto region = begin_region(
+                context.profiler, *command_buffer, graph.passes[i++].name);
+
+            vkCmdExecuteCommands(*command_buffer, 1, &secondary);
+            end_region(context.profiler, *command_buffer, region);
+        }
     }
 
-    return {};
+    // Read back offscreen image.
+    if(is_headless && context.offscreen.parameters.is_readback_enabled) {
+        auto region =
+            begin_region(context.profiler, *command_buffer, "read-back");
+
+        record_readback(context.offscreen, *command_buffer, image_index);
+        end_region(context.profiler, *command_buffer, region);
+    }
+
+    if(vkEndCommandBuffer(*command_buffer) != VK_SUCCESS) {
+        return std::unexpected{error{.line = __LINE__}};
+    }
+
+    return *command_buffer;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // Swapchain initialization function.
 ////////////////////////////////////////////////////////////////////////////////
 
+// Note: The extent is the size of the window, which is obtained by the event
+// thread.
 auto
-initialize_swapchain(main_context& context) -> std::expected<void, error> {
-    // Clear array of swapchain images.
-    context.swapchain_images.clear();
-
+initialize_swapchain(main_context& context, VkExtent2D extent)
+    -> std::expected<void, error> {
     // Update swapchain parameters.
-    if(auto width = 0, height = 0; true) {
-        if(SDL_GetWindowSize(context.window, &width, &height);
-           (width <= 0) || (height <= 0)) {
-            return std::unexpected{error{.line = __LINE__}};
-        }
-
-        context.swapchain_parameters.image_extent.width =
-            static_cast<uint32_t>(width);
-
-        context.swapchain_parameters.image_extent.height =
-            static_cast<uint32_t>(height);
+    if((extent.width == 0) || (extent.height == 0)) {
+        return std::unexpected{error{.line = __LINE__}};
     }
 
-    // Initialize the swapchain.
+    context.swapchain_parameters.image_extent = extent;
+
+    // Initialize the swapchain. The previous swapchain, if any, is passed as
+    // the old swapchain.
     if(context.swapchain.parent = context.device; true) {
-        auto object = initialize(
-            std::move(context.swapchain), context.swapchain_parameters);
+        auto object =
+            initialize(context.swapchain, context.swapchain_parameters);
 
         if(!object) {
             return std::unexpected{
                 error{.line = __LINE__, .underlying = object.error()}};
-        } else {
-            context.swapchain = std::move(*object);
         }
+
+        // Retire the previous swapchain instead of waiting for the device to
+        // become idle: it is destroyed once the last frame which used it
+        // completes. Its rendering semaphores are retired later (see the
+        // render function).
+        if(context.swapchain.handle != nullptr) {
+            auto& semaphores = context.rendering_semaphores;
+            try {
+                context.old_rendering_semaphores.insert(
+                    context.old_rendering_semaphores.end(),
+                    std::make_move_iterator(semaphores.begin()),
+                    std::make_move_iterator(semaphores.end()));
+            } catch(...) {
+                return std::unexpected{error{.line = __LINE__}};
+            }
+
+            semaphores.clear();
+
+            auto point = obtain_last_point(
+                context.scheduler, vulkan::queue_type::graphics);
+
+            retire(
+                context.device, std::move(context.swapchain),
+                vulkan::retirement_point{
+                    .semaphore = point.semaphore, .value = point.value});
+        }
+
+        context.swapchain = std::move(*object);
     }
 
     // Obtain swapchain images.
@@ -257,81 +499,47 @@ initialize_swapchain(main_context& context) -> std::expected<void, error> {
         context.swapchain_images = std::move(*images);
     }
 
-    // Construct command buffers.
-    return construct_command_buffers(context);
-}
+    // Initialize per-image synchronization primitives.
+    if(auto n = context.swapchain_images.size(); true) {
+        context.rendering_semaphores.resize(n);
 
-////////////////////////////////////////////////////////////////////////////////
-// Main context initialization function.
-////////////////////////////////////////////////////////////////////////////////
-
-auto
-initialize_main_context(SDL_Window* window)
-    -> std::expected<main_context, error> {
-    // Initialize an empty result.
-    auto context = main_context{.window = window};
-
-    // Initialize Vulkan instance.
-    if(true) {
-        auto object = initialize(vulkan::instance_parameters{
-            .api_version = VK_API_VERSION_1_3,
-            .extensions = obtain_instance_extensions(window)});
+        for(auto& semaphore : context.rendering_semaphores) {
+            auto object = initialize<vulkan::semaphore>(
+                vkCreateSemaphore, context.device,
+                {.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO});
 
-        if(!object) {
-            return std::unexpected{
-                error{.line = __LINE__, .underlying = object.error()}};
-        } else {
-            context.instance = std::move(*object);
+            if(!object) {
+                return std::unexpected{
+                    error{.line = __LINE__, .underlying = object.error()}};
+            } else {
+                semaphore = std::move(*object);
+            }
         }
     }
 
-    // Select physical device.
-    if(true) {
-        auto object = select(
-            context.instance,
-            vulkan::physical_device_preference{
-                .api_version = VK_API_VERSION_1_3,
-                .type = VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU});
+    return {};
+}
 
-        if(!object) {
-            return std::unexpected{
-                error{.line = __LINE__, .underlying = object.error()}};
-        } else {
-            context.physical_device = *object;
-        }
-    }
+// Note: Recreates the swapchain, and reports the failure, if any. Returns true
+// on success.
+auto
+recreate_swapchain(main_context& context, VkExtent2D extent) -> bool {
+    if(auto result = initialize_swapchain(context, extent); !result) {
+        std::cout << "Swapchain recreation failed (line " << result.error().line
+                  << ", code " << result.error().underlying.code << ").\n";
 
-    // Obtain physical device features.
-    auto features = vulkan::physical_device_features{context.physical_device};
-    if(true) {
-        // Check for support of specific features.
-        // Note: This should vary depending on particular application
-        // requirements.
-        auto is_feature_complete =
-            features.vulkan_1_2.descriptorIndexing &&
-            features.vulkan_1_2.descriptorBindingVariableDescriptorCount &&
-            features.vulkan_1_2.drawIndirectCount &&
-            features.common.features.multiDrawIndirect &&
-            features.common.features.drawIndirectFirstInstance;
-
-        if(!is_feature_complete) {
-            return std::unexpected{error{.line = __LINE__}};
-        }
+        return false;
     }
 
-    // Create window surface.
-    if(true) {
-        auto object = initialize(
-            context.instance, vulkan::surface_parameters{.window = window});
+    return true;
+}
 
-        if(!object) {
-            return std::unexpected{
-                error{.line = __LINE__, .underlying = object.error()}};
-        } else {
-            context.surface = std::move(*object);
-        }
-    }
+////////////////////////////////////////////////////////////////////////////////
+// Presentation initialization function.
+////////////////////////////////////////////////////////////////////////////////
 
+auto
+initialize_presentation(main_context& context) -> std::expected<void, error> {
     // Obtain surface properties.
     if(true) {
         auto object =
@@ -388,14 +596,153 @@ initialize_main_context(SDL_Window* window)
         }
     }
 
-    // Initialize Vulkan device.
+    // Initialize frame pacer. FIFO presentation paces frames by itself, so
+    // frames are started just in time to reduce input latency. Other modes
+    // are capped at the display's refresh rate, which is followed by the
+    // render loop afterwards.
+    context.pacer = vulkan::initialize(vulkan::pacing_parameters{
+        .policy = (context.swapchain_parameters.present_mode ==
+                   VK_PRESENT_MODE_FIFO_KHR)
+                      ? vulkan::pacing_policy::low_latency
+                      : vulkan::pacing_policy::target_rate,
+        .frame_duration =
+            compute_frame_duration(obtain_refresh_rate(context.window)),
+        .spin_duration = std::chrono::microseconds{500}});
+
+    return {};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Main context initialization function.
+////////////////////////////////////////////////////////////////////////////////
+
+auto
+initialize_main_context(SDL_Window* window, main_parameters parameters)
+    -> std::expected<main_context, error> {
+    // Initialization fails if no frames in flight are requested.
+    if(parameters.frame_count == 0) {
+        return std::unexpected{error{.line = __LINE__}};
+    }
+
+    // Initialize an empty result.
+    auto context = main_context{.window = window};
+
+    // Initialize Vulkan instance.
+    if(true) {
+        auto object = initialize(vulkan::instance_parameters{
+            .api_version = VK_API_VERSION_1_3,
+            .extensions = obtain_instance_extensions(window)});
+
+        if(!object) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = object.error()}};
+        } else {
+            context.instance = std::move(*object);
+        }
+    }
+
+    // Create window surface, so that devices which can not present to it are
+    // rejected during selection. Headless context does not have a surface.
+    if(window != nullptr) {
+        auto object = initialize(
+            context.instance, vulkan::surface_parameters{.window = window});
+
+        if(!object) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = object.error()}};
+        } else {
+            context.surface = std::move(*object);
+        }
+    }
+
+    // Device extensions. Optional extensions are added if the selected device
+    // supports them.
+    auto device_extensions = obtain_device_extensions(window);
+    auto is_calibration_supported = false;
+
+    // Select physical device. Devices which lack required features are
+    // rejected; others are ranked, so that discrete GPUs are preferred, but
+    // headless context also accepts CPU implementations, such as lavapipe.
+    // Note: Required features should vary depending on particular application
+    // requirements.
+    if(true) {
+        auto required_features = vulkan::physical_device_features{nullptr};
+        required_features.vulkan_1_2.descriptorIndexing = VK_TRUE;
+        required_features.vulkan_1_2.descriptorBindingVariableDescriptorCount =
+            VK_TRUE;
+        required_features.vulkan_1_2
+            .descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        required_features.vulkan_1_2
+            .descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+        required_features.vulkan_1_2
+            .descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+        required_features.vulkan_1_2.descriptorBindingPartiallyBound = VK_TRUE;
+        required_features.vulkan_1_2.drawIndirectCount = VK_TRUE;
+        required_features.vulkan_1_2.timelineSemaphore = VK_TRUE;
+        required_features.vulkan_1_3.synchronization2 = VK_TRUE;
+        required_features.common.features.multiDrawIndirect = VK_TRUE;
+        required_features.common.features.drawIndirectFirstInstance = VK_TRUE;
+
+        auto object = select(
+            context.instance,
+            vulkan::physical_device_selection_parameters{
+                .requirements = {.api_version = VK_API_VERSION_1_3,
+                                 .extensions = device_extensions,
+                                 .features = &required_features,
+                                 .surface = context.surface},
+                .cache_path = "device_profiles.bin"});
+
+        if(!object) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = object.error()}};
+        } else {
+            context.physical_device = object->physical_device;
+        }
+
+        std::cout << "Device: " << object->profile.properties.deviceName
+                  << " (score " << object->score << ")\n";
+
+        // Enable calibrated timestamps for the profiler, if supported.
+        is_calibration_supported =
+            std::ranges::any_of(object->profile.extensions, [](auto const& x) {
+                return std::string_view{x.extensionName} ==
+                       VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME;
+            });
+
+        if(is_calibration_supported) {
+            device_extensions.push_back(
+                VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME);
+        }
+    }
+
+    // Obtain physical device features.
+    auto features = vulkan::physical_device_features{context.physical_device};
+
+    // Initialize presentation. Headless context does not present, so its
+    // frames are not paced.
+    if(window != nullptr) {
+        if(auto result = initialize_presentation(context); !result) {
+            return std::unexpected{result.error()};
+        }
+    } else {
+        context.pacer = vulkan::initialize(vulkan::pacing_parameters{
+            .policy = vulkan::pacing_policy::uncapped});
+    }
+
+    // Initialize Vulkan device. Background compute and transfer queues have
+    // lower priority than rendering.
     if(true) {
+        static constexpr float background_priorities[] = {0.5f};
+
         auto object = initialize(
             context.physical_device,
             vulkan::device_parameters{
-                .extensions = obtain_device_extensions(),
+                .extensions = device_extensions,
                 .features = features,
-                .surface = context.surface});
+                .surface = context.surface,
+                .queue_priorities = {
+                    .compute = background_priorities,
+                    .transfer = background_priorities}});
 
         if(!object) {
             return std::unexpected{
@@ -408,59 +755,147 @@ initialize_main_context(SDL_Window* window)
     // Obtain device queues.
     context.device_queues = obtain_queue_list(context.device);
 
-    // Initialize semaphores.
+    // Initialize submission scheduler.
     if(true) {
-        auto semaphores = std::array{
-            &(context.semaphores.rendering), &(context.semaphores.swapchain)};
+        auto object = initialize(context.device, context.device_queues);
+        if(!object) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = object.error()}};
+        } else {
+            context.scheduler = std::move(*object);
+        }
+    }
 
-        for(auto target : semaphores) {
-            auto object = initialize<vulkan::semaphore>(
-                vkCreateSemaphore, context.device,
-                {.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO});
+    // Initialize pipeline cache.
+    if(true) {
+        auto object = initialize(
+            context.device,
+            vulkan::pipeline_cache_parameters{.path = "pipeline_cache.bin"});
 
-            if(!object) {
-                return std::unexpected{
-                    error{.line = __LINE__, .underlying = object.error()}};
-            } else {
-                *target = std::move(*object);
-            }
+        if(!object) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = object.error()}};
+        } else {
+            context.pipeline_cache = std::move(*object);
         }
     }
 
-    // Initialize command pool.
+    // Initialize descriptor heap.
     if(true) {
-        auto object = initialize<vulkan::command_pool>(
-            vkCreateCommandPool, context.device,
-            {.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
-             .queueFamilyIndex = context.device.queue_family_index.graphics});
+        auto object = initialize(
+            context.device, vulkan::descriptor_heap_parameters{
+                                .sampled_image_count = 1 << 16,
+                                .storage_buffer_count = 1 << 16,
+                                .sampler_count = 1 << 10});
 
         if(!object) {
             return std::unexpected{
                 error{.line = __LINE__, .underlying = object.error()}};
         } else {
-            context.command_pool = std::move(*object);
+            context.descriptor_heap = std::move(*object);
         }
     }
 
-    // Allocate command buffers.
+    // Initialize frames in flight.
+    context.frames.resize(parameters.frame_count);
+    for(auto& frame : context.frames) {
+        auto object = initialize<vulkan::semaphore>(
+            vkCreateSemaphore, context.device,
+            {.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO});
+
+        if(!object) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = object.error()}};
+        } else {
+            frame.swapchain = std::move(*object);
+        }
+    }
+
+    // Initialize profiler.
     if(true) {
-        auto command_buffers = std::span{context.command_buffers};
+        auto object = initialize(
+            context.device,
+            vulkan::profiler_parameters{
+                .queue_family_index =
+                    context.device.queue_family_index.graphics,
+                .frame_count = parameters.frame_count,
+                .region_count = 16,
+                .event_count = 1 << 16,
+                .is_calibration_enabled = is_calibration_supported});
 
-        auto info = VkCommandBufferAllocateInfo{
-            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-            .commandPool = context.command_pool,
-            .commandBufferCount = vulkan::size(command_buffers)};
+        if(!object) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = object.error()}};
+        } else {
+            context.profiler = std::move(*object);
+        }
+    }
 
-        if(vkAllocateCommandBuffers(
-               context.device, &info, vulkan::data(command_buffers)) !=
-           VK_SUCCESS) {
-            return std::unexpected{error{.line = __LINE__}};
+    // Initialize job pool.
+    if(true) {
+        auto object = initialize(vulkan::job_pool_parameters{});
+        if(!object) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = object.error()}};
+        } else {
+            context.job_pool = std::move(*object);
+        }
+    }
+
+    // Initialize render graph.
+    context.graph = vulkan::initialize(vulkan::render_graph_parameters{
+        .queue_family_index = context.device.queue_family_index.graphics});
+
+    // Initialize command buffer recorder.
+    if(true) {
+        auto object = initialize(
+            context.device, context.job_pool,
+            vulkan::recording_parameters{
+                .queue_family_index =
+                    context.device.queue_family_index.graphics,
+                .frame_count = parameters.frame_count});
+
+        if(!object) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = object.error()}};
+        } else {
+            context.recorder = std::move(*object);
         }
     }
 
-    // Initialize swapchain.
-    if(auto result = initialize_swapchain(context); !result) {
-        return std::unexpected{result.error()};
+    // Initialize swapchain, or offscreen target in headless mode. Each frame
+    // in flight has its own offscreen image.
+    if(window != nullptr) {
+        if(auto result =
+               initialize_swapchain(context, obtain_window_extent(window));
+           !result) {
+            return std::unexpected{result.error()};
+        }
+    } else {
+        auto object = initialize(
+            context.device,
+            vulkan::offscreen_parameters{
+                .format = VK_FORMAT_R8G8B8A8_UNORM,
+                .extent = parameters.extent,
+                .image_usage_flags = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
+                                     VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                                     VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                .image_count = parameters.frame_count,
+                .is_readback_enabled = parameters.is_readback_enabled});
+
+        if(!object) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = object.error()}};
+        } else {
+            context.offscreen = std::move(*object);
+        }
+
+        if(auto images = obtain_images(context.offscreen); !images) {
+            return std::unexpected{
+                error{.line = __LINE__, .underlying = images.error()}};
+        } else {
+            context.swapchain_images = std::move(*images);
+        }
     }
 
     return std::move(context);
@@ -470,55 +905,376 @@ initialize_main_context(SDL_Window* window)
 // Rendering function.
 ////////////////////////////////////////////////////////////////////////////////
 
-void
-render(main_context& context) {
-    if(auto width = 0, height = 0; true) {
-        if(SDL_GetWindowSize(context.window, &width, &height);
-           (width <= 0) || (height <= 0)) {
-            return;
+// Note: Returns true if a frame was queued for presentation (or rendered, in
+// headless mode).
+auto
+render(main_context& context, frame_state const& state) -> bool {
+    // Skip rendering while the window has no area, recreate the swapchain if
+    // the window was resized, and follow the refresh rate of its display. The
+    // window's state is obtained by the event thread.
+    if(auto extent = state.window_extent; context.window != nullptr) {
+        if((extent.width == 0) || (extent.height == 0)) {
+            return false;
+        }
+
+        if(auto current = context.swapchain_parameters.image_extent;
+           (extent.width != current.width) ||
+           (extent.height != current.height)) {
+            if(!recreate_swapchain(context, extent)) {
+                return false;
+            }
+        }
+
+        if(state.refresh_rate != 0) {
+            context.pacer.parameters.frame_duration =
+                compute_frame_duration(state.refresh_rate);
         }
     }
 
-    // Acquire the next swapchain image.
+    // Destroy retired resources whose frames have completed.
+    if(!collect(context.device)) {
+        return false;
+    }
+
+    // Make sure the time spent waiting for the GPU is recorded upon return
+    // from this function.
+    struct guard {
+        ~guard() {
+            record_wait(pacer, vulkan::pacer::clock::now() - t0);
+        }
+
+        vulkan::pacer& pacer;
+        vulkan::pacer::clock::time_point t0;
+    };
+
+    // Wait for the previous use of the frame to complete.
+    auto& frame = context.frames[context.frame_index];
+    if(guard _{.pacer = context.pacer, .t0 = vulkan::pacer::clock::now()};
+       !wait(context.scheduler, frame.completion)) {
+        return false;
+    }
+
+    // Acquire the next swapchain image. Out-of-date swapchain is recreated
+    // immediately, and suboptimal swapchain is recreated after presentation.
+    // In headless mode offscreen images are acquired in turn.
     auto image_index = uint32_t{};
-    if(vkAcquireNextImageKHR(
-           context.device, context.swapchain, UINT64_MAX,
-           context.semaphores.swapchain, nullptr, &image_index) != VK_SUCCESS) {
-        return;
+    auto is_swapchain_suboptimal = false;
+
+    if(context.window == nullptr) {
+        image_index = acquire(context.offscreen);
+    } else {
+        auto t0 = vulkan::pacer::clock::now();
+        auto code = vkAcquireNextImageKHR(
+            context.device, context.swapchain, UINT64_MAX, frame.swapchain,
+            nullptr, &image_index);
+
+        record_acquire(context.pacer, vulkan::pacer::clock::now() - t0);
+
+        switch(code) {
+            case VK_SUCCESS:
+                break;
+
+            case VK_SUBOPTIMAL_KHR:
+                is_swapchain_suboptimal = true;
+                break;
+
+            case VK_ERROR_OUT_OF_DATE_KHR:
+                recreate_swapchain(context, state.window_extent);
+                return false;
+
+            default:
+                return false;
+        }
     }
 
-    // Render the next frame.
-    if(true) {
-        VkPipelineStageFlags pipeline_stage_flags[] = {
-            VK_PIPELINE_STAGE_TRANSFER_BIT};
+    // Record the frame.
+    auto command_buffer = record_frame(context, state, image_index);
+    if(!command_buffer) {
+        return false;
+    }
 
-        auto info = VkSubmitInfo{
-            .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-            .waitSemaphoreCount = 1,
-            .pWaitSemaphores = &(context.semaphores.swapchain.handle),
-            .pWaitDstStageMask = pipeline_stage_flags,
-            .commandBufferCount = 1,
-            .pCommandBuffers = &(context.command_buffers[image_index]),
-            .signalSemaphoreCount = 1,
-            .pSignalSemaphores = &(context.semaphores.rendering.handle)};
+    // Apply descriptor updates before the frame is submitted.
+    if(!flush(context.descriptor_heap)) {
+        return false;
+    }
 
-        if(vkQueueSubmit(context.device_queues.graphics, 1, &info, nullptr) !=
-           VK_SUCCESS) {
-            return;
+    // Advance to the next frame.
+    context.frame_index = (context.frame_index + 1) % context.frames.size();
+
+    // Render the next frame. Swapchain semaphores are used only when there is
+    // a swapchain.
+    if(auto n = ((context.window != nullptr) ? 1zU : 0zU); true) {
+        VkSemaphoreSubmitInfo waits[] = {
+            {.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+             .semaphore = frame.swapchain,
+             .stageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT}};
+
+        VkSemaphoreSubmitInfo signals[] = {
+            {.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO,
+             .stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT}};
+
+        if(n != 0) {
+            signals[0].semaphore = context.rendering_semaphores[image_index];
+        }
+
+        auto point = enqueue(
+            context.scheduler,
+            vulkan::work_item{
+                .queue = vulkan::queue_type::graphics,
+                .command_buffers = std::span{&(*command_buffer), 1},
+                .waits = std::span{waits}.first(n),
+                .signals = std::span{signals}.first(n)});
+
+        if(!point || !flush(context.scheduler)) {
+            return false;
+        }
+
+        frame.completion = *point;
+
+        // Retire rendering semaphores of previous swapchains. Note: This frame
+        // waits for an image of the current swapchain, which is acquired only
+        // after presentations which waited on the retired semaphores.
+        if(!context.old_rendering_semaphores.empty()) {
+            retire(
+                context.device, std::move(context.old_rendering_semaphores),
+                vulkan::retirement_point{
+                    .semaphore = point->semaphore, .value = point->value});
+
+            context.old_rendering_semaphores.clear();
         }
     }
 
     // Present rendered frame.
-    if(true) {
+    if(context.window != nullptr) {
         auto info = VkPresentInfoKHR{
             .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
             .waitSemaphoreCount = 1,
-            .pWaitSemaphores = &(context.semaphores.rendering.handle),
+            .pWaitSemaphores =
+                &(context.rendering_semaphores[image_index].handle),
             .swapchainCount = 1,
             .pSwapchains = &(context.swapchain.handle),
             .pImageIndices = &image_index};
 
-        vkQueuePresentKHR(context.device_queues.presentation, &info);
+        switch(vkQueuePresentKHR(context.device_queues.presentation, &info)) {
+            case VK_SUBOPTIMAL_KHR:
+            case VK_ERROR_OUT_OF_DATE_KHR:
+                is_swapchain_suboptimal = true;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    // Recreate the swapchain, if needed.
+    if(is_swapchain_suboptimal) {
+        recreate_swapchain(context, state.window_extent);
+    }
+
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Event processing function.
+////////////////////////////////////////////////////////////////////////////////
+
+// Note: Applies pending events to the simulation state, and passes input
+// events to the render thread. Returns false if the program should stop.
+auto
+process_events(SDL_Window* window, simulation& simulation, handoff& handoff)
+    -> bool {
+    auto should_run = true;
+    for(SDL_Event event; SDL_PollEvent(&event) != 0;) {
+        auto time = input_event::clock::now();
+        auto is_input = true;
+
+        switch(event.type) {
+            case SDL_QUIT:
+                // Quitting is never reflected by frames, so it is not
+                // measured.
+                should_run = false;
+                is_input = false;
+                break;
+
+            case SDL_KEYDOWN:
+                switch(event.key.keysym.sym) {
+                    case SDLK_q:
+                        should_run = false;
+                        break;
+
+                    default:
+                        break;
+                }
+                break;
+
+            case SDL_KEYUP:
+                break;
+
+            case SDL_MOUSEBUTTONDOWN:
+                if(event.button.button == SDL_BUTTON_LEFT) {
+                    // Process mouse button event.
+                }
+
+                break;
+
+            case SDL_MOUSEBUTTONUP:
+                if(event.button.button == SDL_BUTTON_LEFT) {
+                    // Process mouse button event.
+                }
+
+                break;
+
+            case SDL_MOUSEMOTION:
+                // Pointer position controls the clear color.
+                if(auto width = 0, height = 0; true) {
+                    SDL_GetWindowSize(window, &width, &height);
+
+                    simulation.x = static_cast<float>(event.motion.x) /
+                                   static_cast<float>(std::max(width, 1));
+
+                    simulation.y = static_cast<float>(event.motion.y) /
+                                   static_cast<float>(std::max(height, 1));
+                }
+
+                break;
+
+            default:
+                is_input = false;
+                break;
+        }
+
+        // Pass the input event to the render thread. Events which do not fit
+        // in the queue are not measured.
+        if(is_input) {
+            ++simulation.input_sequence;
+
+            if(!push(
+                   handoff.events,
+                   input_event{
+                       .type = event.type,
+                       .sequence = simulation.input_sequence,
+                       .time = time})) {
+                ++handoff.dropped_event_count;
+            }
+        }
+    }
+
+    return should_run;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Simulation function.
+////////////////////////////////////////////////////////////////////////////////
+
+// Note: Runs on the event thread until the program should stop. Each step
+// waits briefly for events, so that input is received as soon as it arrives,
+// and publishes the resulting frame state.
+void
+simulate(SDL_Window* window, handoff& handoff) {
+    auto state = simulation{.x = 0.5f, .y = 0.5f};
+    auto window_extent = VkExtent2D{};
+    auto refresh_rate = uint32_t{};
+
+    while(handoff.is_running.load(std::memory_order_acquire)) {
+        // Receive events, and obtain the window's state. Headless mode has no
+        // events.
+        if(window != nullptr) {
+            SDL_WaitEventTimeout(nullptr, 1);
+
+            if(!process_events(window, state, handoff)) {
+                handoff.is_running.store(false, std::memory_order_release);
+            }
+
+            window_extent = obtain_window_extent(window);
+            refresh_rate = obtain_refresh_rate(window);
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+
+        // Publish the frame state.
+        obtain_back(handoff.frames) = frame_state{
+            .color = {.float32 = {state.x, state.y, 0.1f, 1.0f}},
+            .input_sequence = state.input_sequence,
+            .window_extent = window_extent,
+            .refresh_rate = refresh_rate};
+
+        publish(handoff.frames);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Render loop function.
+////////////////////////////////////////////////////////////////////////////////
+
+// Note: Runs on the render thread until the program should stop. In headless
+// mode the loop stops by itself after the given number of frames.
+void
+run_render_loop(
+    main_context& context, handoff& handoff, latency_history& latencies,
+    size_t frame_count) {
+    using clock = vulkan::profiler::clock;
+
+    // Input event which is not yet reflected by the acquired frame state, and
+    // the time of the earliest input event which is reflected by acquired
+    // frame states, but not yet by a presented frame.
+    auto pending = std::optional<input_event>{};
+    auto input_time = std::optional<clock::time_point>{};
+
+    for(auto i = 1zU; handoff.is_running.load(std::memory_order_acquire);
+        ++i) {
+        // Acquire the latest frame state, and consume input events which it
+        // reflects. The earliest of them determines the latency of the next
+        // presented frame.
+        auto t0 = clock::now();
+        auto const& state = acquire(handoff.frames);
+
+        while(true) {
+            if(!pending) {
+                pending = pop(handoff.events);
+            }
+
+            if(!pending || (pending->sequence > state.input_sequence)) {
+                break;
+            }
+
+            if(!input_time) {
+                input_time = pending->time;
+            }
+
+            pending.reset();
+        }
+
+        if((context.window == nullptr) && (i >= frame_count)) {
+            handoff.is_running.store(false, std::memory_order_release);
+        }
+
+        // Render the next frame.
+        auto t1 = clock::now();
+        auto is_presented = render(context, state);
+
+        // Record input-to-present latency.
+        auto t2 = clock::now();
+        if(is_presented) {
+            if(input_time && !latencies.samples.empty()) {
+                latencies
+                    .samples[latencies.count++ % latencies.samples.size()] =
+                    t2 - *input_time;
+
+                record_span(
+                    context.profiler, "input latency", *input_time, t2);
+            }
+
+            input_time.reset();
+        }
+
+        // Wait for the start of the next frame.
+        pace(context.pacer);
+
+        // Record CPU spans.
+        auto t3 = clock::now();
+        record_span(context.profiler, "input", t0, t1);
+        record_span(context.profiler, "render", t1, t2);
+        record_span(context.profiler, "pace", t2, t3);
     }
 }
 
@@ -529,103 +1285,181 @@ render(main_context& context) {
 ////////////////////////////////////////////////////////////////////////////////
 
 int
-main() {
-    // Initialize SDL subsystems.
-    if(SDL_Init(SDL_INIT_VIDEO) != 0) {
+main(int argc, char* argv[]) {
+    // Parse command line arguments.
+    auto is_headless = false;
+    auto frame_count = 100zU;
+    auto dump_path = std::filesystem::path{};
+
+    auto is_valid = true;
+    for(auto i = 1; is_valid && (i < argc); ++i) {
+        auto argument = std::string_view{argv[i]};
+        if(argument == "--headless") {
+            is_headless = true;
+        } else if((argument == "--frames") && ((i + 1) < argc)) {
+            // Note: The number of frames must be a positive decimal number.
+            auto value = std::string_view{argv[++i]};
+            auto [end, code] = std::from_chars(
+                value.data(), value.data() + value.size(), frame_count);
+
+            is_valid = (code == std::errc{}) &&
+                       (end == (value.data() + value.size())) &&
+                       (frame_count != 0);
+        } else if((argument == "--dump") && ((i + 1) < argc)) {
+            dump_path = argv[++i];
+        } else {
+            is_valid = false;
+        }
+    }
+
+    // Print usage on invalid arguments.
+    // Note: The number of frames and the dump are used only in headless mode.
+    if(!is_valid) {
+        std::cout << "Usage: main [--headless] [--frames N] [--dump PATH]\n";
+        return EXIT_FAILURE;
+    }
+
+    // Initialize SDL subsystems. Headless mode does not use SDL.
+    if(!is_headless && (SDL_Init(SDL_INIT_VIDEO) != 0)) {
         return EXIT_FAILURE;
     }
 
     // Make sure SDL state is cleaned-up upon exit.
     struct guard {
         ~guard() {
-            std::cout << "Deleting SDL state\n";
-            SDL_Quit();
+            if(is_initialized) {
+                std::cout << "Deleting SDL state\n";
+                SDL_Quit();
+            }
         }
-    } _;
 
-    // Create a new window.
-    auto window = rose::window{SDL_CreateWindow(
-        "Main", 0, 0, 1280, 720, SDL_WINDOW_BORDERLESS | SDL_WINDOW_VULKAN)};
+        bool is_initialized;
+    } _{.is_initialized = !is_headless};
 
-    if(!window) {
-        return EXIT_FAILURE;
+    // Create a new window.
+    auto window = rose::window{};
+    if(!is_headless) {
+        window.reset(SDL_CreateWindow(
+            "Main", 0, 0, 1280, 720,
+            SDL_WINDOW_BORDERLESS | SDL_WINDOW_VULKAN));
+
+        if(!window) {
+            return EXIT_FAILURE;
+        }
     }
 
     // Initialize main context.
-    auto context = rose::initialize_main_context(window.get());
+    auto context = rose::initialize_main_context(
+        window.get(),
+        rose::main_parameters{
+            .frame_count = 2,
+            .extent = {1280, 720},
+            .is_readback_enabled = (is_headless && !dump_path.empty())});
+
     if(!context) {
         std::cout << "Main context initialization failed.\n";
         return EXIT_FAILURE;
     }
 
-    // Run event loop.
-    for(bool should_run = true; should_run;) {
-        // Get current frame time.
-        auto t0 = std::chrono::high_resolution_clock::now();
+    // Initialize thread handoff.
+    auto handoff = rose::handoff{.is_running = true};
 
-        // Process events.
-        for(SDL_Event event; SDL_PollEvent(&event) != 0;) {
-            switch(event.type) {
-                case SDL_QUIT:
-                    should_run = false;
-                    break;
-
-                case SDL_KEYDOWN:
-                    switch(event.key.keysym.sym) {
-                        case SDLK_q:
-                            should_run = false;
-                            break;
-
-                        default:
-                            break;
-                    }
-                    break;
+    if(auto queue = rose::vulkan::initialize<rose::input_event>(
+           rose::vulkan::spsc_queue_parameters{.capacity = 1024});
+       !queue) {
+        return EXIT_FAILURE;
+    } else {
+        handoff.events = std::move(*queue);
+    }
 
-                case SDL_KEYUP:
-                    break;
+    if(auto buffer = rose::vulkan::initialize(
+           rose::vulkan::triple_buffer_parameters<rose::frame_state>{
+               .value = {
+                   .color = {.float32 = {0.5f, 0.5f, 0.1f, 1.0f}},
+                   .window_extent =
+                       context->swapchain_parameters.image_extent}}});
+       !buffer) {
+        return EXIT_FAILURE;
+    } else {
+        handoff.frames = std::move(*buffer);
+    }
 
-                case SDL_MOUSEBUTTONDOWN:
-                    if(event.button.button == SDL_BUTTON_LEFT) {
-                        // Process mouse button event.
-                    }
+    // Run the render loop on a dedicated thread, and the event loop on this
+    // thread, so that slow frames do not delay input, and bursts of input do
+    // not delay frames. In headless mode the render loop runs for the given
+    // number of frames.
+    auto latencies = rose::latency_history{
+        .samples = std::vector<std::chrono::nanoseconds>(4096)};
+
+    if(auto thread = std::jthread{[&] {
+           rose::run_render_loop(*context, handoff, latencies, frame_count);
+       }};
+       true) {
+        rose::simulate(window.get(), handoff);
+    }
 
-                    break;
+    // Report frame time statistics.
+    if(auto statistics = obtain_statistics(context->pacer); true) {
+        auto ms = [](std::chrono::nanoseconds x) {
+            return std::chrono::duration<double, std::milli>{x}.count();
+        };
+
+        std::cout << "Frames: " << statistics.frame_count << "\n"
+                  << "Frame time (ms): p50 " << ms(statistics.p50) << ", p90 "
+                  << ms(statistics.p90) << ", p99 " << ms(statistics.p99)
+                  << ", max " << ms(statistics.max) << "\n"
+                  << "CPU time (ms): " << ms(statistics.cpu_time)
+                  << ", GPU wait time (ms): " << ms(statistics.wait_time)
+                  << ", acquire time (ms): " << ms(statistics.acquire_time)
+                  << "\n";
+    }
 
-                case SDL_MOUSEBUTTONUP:
-                    if(event.button.button == SDL_BUTTON_LEFT) {
-                        // Process mouse button event.
-                    }
+    // Report input-to-present latency statistics.
+    if(auto n = std::min(latencies.count, latencies.samples.size()); n != 0) {
+        auto samples = std::span{latencies.samples}.first(n);
+        std::ranges::sort(samples);
+
+        auto ms = [](std::chrono::nanoseconds x) {
+            return std::chrono::duration<double, std::milli>{x}.count();
+        };
+
+        std::cout << "Input-to-present latency (ms): p50 "
+                  << ms(samples[n / 2]) << ", p99 "
+                  << ms(samples[std::min((n * 99) / 100, n - 1)]) << ", max "
+                  << ms(samples.back()) << " (" << latencies.count
+                  << " frames, " << handoff.dropped_event_count
+                  << " dropped events)\n";
+    }
 
-                    break;
+    // Wait for device to become idle.
+    if(context->device.handle != nullptr) {
+        vkDeviceWaitIdle(context->device);
+    }
 
-                case SDL_MOUSEMOTION:
-                    // Process mouse motion event.
-                    break;
+    // Store the last rendered image.
+    if(is_headless && !dump_path.empty()) {
+        auto& offscreen = context->offscreen;
+        auto data = read(offscreen, offscreen.image_index);
 
-                default:
-                    break;
-            }
+        if(!data || !store_image(offscreen, dump_path, *data)) {
+            std::cout << "Failed to store the image.\n";
         }
+    }
 
-        // Render the next frame.
-        render(*context);
+    // Store the trace.
+    if(!store_trace(context->profiler, "trace.json")) {
+        std::cout << "Failed to store the trace.\n";
+    }
 
-        // Sleep between frames to reduce CPU load.
-        auto delta = std::chrono::duration_cast<std::chrono::milliseconds>(
-            std::chrono::high_resolution_clock::now() - t0);
+    // Store pipeline cache.
+    if(auto statistics = obtain_statistics(context->pipeline_cache); true) {
+        std::cout << "Pipeline cache: " << statistics.hit_count << " hits, "
+                  << statistics.miss_count << " misses\n";
 
-        if(delta.count() < 16) {
-            auto dt = 16 - delta.count();
-            std::this_thread::sleep_for(std::chrono::milliseconds{dt});
-        } else {
-            std::this_thread::sleep_for(std::chrono::milliseconds{2});
+        if(!store(context->pipeline_cache)) {
+            std::cout << "Failed to store pipeline cache.\n";
         }
     }
 
-    // Wait for device to become idle.
-    if(context->device.handle != nullptr) {
-        vkDeviceWaitIdle(context->device);
-    }
-
     return EXIT_SUCCESS;
 }